@@ -0,0 +1,111 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "AnimationRegistry.h"
+#include "ResourceLoader.h"
+
+using namespace cocos2d;
+
+// in FrameId order
+static const char* FRAME_NAMES[] = {
+    "runner0.png",
+    "runner1.png",
+    "runner2.png",
+    "runner3.png",
+    "runner4.png",
+    "runner5.png",
+    "runner6.png",
+    "runner7.png",
+    "runnerJumpUp0.png",
+    "runnerJumpUp1.png",
+    "runnerJumpUp2.png",
+    "runnerJumpUp3.png",
+    "runnerCrouch0.png",
+    "coin0.png",
+    "coin1.png",
+    "coin2.png",
+    "coin3.png",
+    "coin4.png",
+    "coin5.png",
+    "coin6.png",
+    "coin7.png",
+    "box.png",
+    "anvil.png",
+};
+static_assert(sizeof(FRAME_NAMES)/sizeof(FRAME_NAMES[0]) == AnimationRegistry::FRAMES, "a name for every FrameId");
+
+// in AnimationId order
+static const struct {
+    AnimationRegistry::FrameId first;
+    int frames;
+    float delay;
+} ANIMATION_DEFS[] = {
+    { AnimationRegistry::FRAME_RUNNER0, 8, 0.1 },
+    { AnimationRegistry::FRAME_RUNNER_JUMP_UP0, 4, 0.02 },
+    // the first two jump up frames, World::Config sizes it the same
+    { AnimationRegistry::FRAME_RUNNER_JUMP_UP0, 2, 0.2 },
+};
+static_assert(sizeof(ANIMATION_DEFS)/sizeof(ANIMATION_DEFS[0]) == AnimationRegistry::ANIMATIONS, "an animation for every AnimationId");
+
+AnimationRegistry* AnimationRegistry::getInstance()
+{
+    // never destroyed, like the ResourceLoader: the frames keep
+    // their texture alive
+    static AnimationRegistry* instance = nullptr;
+    if (!instance)
+    {
+        instance = new AnimationRegistry();
+        instance->init();
+    }
+    return instance;
+}
+
+AnimationRegistry::AnimationRegistry()
+: _frames(FRAMES)
+, _animations(ANIMATIONS)
+{
+}
+
+void AnimationRegistry::init()
+{
+    // usually preloaded while the main menu was shown
+    auto frameCache = SpriteFrameCache::getInstance();
+    if (!ResourceLoader::getInstance()->isLoaded("parkour.plist"))
+        frameCache->addSpriteFramesWithFile("parkour.plist");
+
+    for (int i=0; i<FRAMES; i++)
+    {
+        auto frame = frameCache->getSpriteFrameByName(FRAME_NAMES[i]);
+        CCASSERT(frame, "frame missing in parkour.plist");
+        _frames.pushBack(frame);
+    }
+
+    for (auto& animation : ANIMATION_DEFS)
+    {
+        Vector<SpriteFrame*> frames(animation.frames);
+        for (int i=0; i<animation.frames; i++)
+            frames.pushBack(_frames.at(animation.first + i));
+        _animations.pushBack(Animation::createWithSpriteFrames(frames, animation.delay));
+    }
+}
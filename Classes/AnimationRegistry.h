@@ -0,0 +1,86 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include "cocos2d.h"
+
+// The sprite frames and animations of parkour.plist, looked up by name
+// once and kept for the whole process. The game nodes take them by id:
+// creating a GameNode does no string lookups and builds no Animation.
+class AnimationRegistry
+{
+public:
+    enum FrameId {
+        FRAME_RUNNER0,
+        FRAME_RUNNER1,
+        FRAME_RUNNER2,
+        FRAME_RUNNER3,
+        FRAME_RUNNER4,
+        FRAME_RUNNER5,
+        FRAME_RUNNER6,
+        FRAME_RUNNER7,
+        FRAME_RUNNER_JUMP_UP0,
+        FRAME_RUNNER_JUMP_UP1,
+        FRAME_RUNNER_JUMP_UP2,
+        FRAME_RUNNER_JUMP_UP3,
+        FRAME_RUNNER_CROUCH0,
+        FRAME_COIN0,
+        FRAME_COIN1,
+        FRAME_COIN2,
+        FRAME_COIN3,
+        FRAME_COIN4,
+        FRAME_COIN5,
+        FRAME_COIN6,
+        FRAME_COIN7,
+        FRAME_BOX,
+        FRAME_ANVIL,
+
+        FRAMES
+    };
+
+    enum AnimationId {
+        ANIMATION_RUN,
+        ANIMATION_JUMP_UP,
+        ANIMATION_JUMP_DOWN,
+
+        ANIMATIONS
+    };
+
+    static const int COIN_FRAMES = FRAME_COIN7 - FRAME_COIN0 + 1;
+
+    // built on the first call. parkour.plist is loaded if the
+    // ResourceLoader has not done it yet. Main thread
+    static AnimationRegistry* getInstance();
+
+    cocos2d::SpriteFrame* getFrame(FrameId id) const { return _frames.at(id); }
+    cocos2d::Animation* getAnimation(AnimationId id) const { return _animations.at(id); }
+
+protected:
+    AnimationRegistry();
+    void init();
+
+    cocos2d::Vector<cocos2d::SpriteFrame*> _frames;
+    cocos2d::Vector<cocos2d::Animation*> _animations;
+};
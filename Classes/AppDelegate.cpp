@@ -1,5 +1,6 @@
 #include "AppDelegate.h"
 #include "MainMenuNode.h"
+#include "Tracer.h"
 
 USING_NS_CC;
 
@@ -81,6 +82,19 @@ bool AppDelegate::applicationDidFinishLaunching() {
 
     register_all_packages();
 
+#ifdef PARKOUR_ENABLE_TRACER
+    // F9 writes the trace of the last frames
+    auto keyListener = EventListenerKeyboard::create();
+    keyListener->onKeyReleased = [](EventKeyboard::KeyCode keyCode, Event* event){
+        if (keyCode == EventKeyboard::KeyCode::KEY_F9) {
+            auto path = FileUtils::getInstance()->getWritablePath() + "trace.json";
+            Tracer::getInstance()->writeFile(path);
+            CCLOG("trace written to %s", path.c_str());
+        }
+    };
+    director->getEventDispatcher()->addEventListenerWithFixedPriority(keyListener, 1);
+#endif
+
     // create a scene. it's an autorelease object
     auto scene = createSceneWithMainMenu();
 
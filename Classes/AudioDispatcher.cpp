@@ -0,0 +1,156 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "AudioDispatcher.h"
+
+#include "Tracer.h"
+
+// the audio thread checks the queue at least this often, in case a
+// wake up is missed
+static const int MAX_SLEEP_MS = 10;
+
+AudioDispatcher::AudioDispatcher(PlayFunction play)
+: _play(play)
+, _pending(0)
+, _sleeping(false)
+, _quit(false)
+{
+    resetMetrics();
+    _thread = std::thread(&AudioDispatcher::run, this);
+}
+
+AudioDispatcher::~AudioDispatcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _wake.notify_one();
+    _thread.join();
+}
+
+void AudioDispatcher::post(int effect)
+{
+    _posted++;
+    unsigned int bit = 1u << effect;
+    if (_pending & bit)
+        _coalesced++;
+    _pending |= bit;
+}
+
+void AudioDispatcher::flush()
+{
+    if (!_pending)
+        return;
+
+    auto now = Clock::now();
+    for (int effect=0; _pending; effect++, _pending >>= 1)
+    {
+        if ((_pending & 1) && !_queue.push({effect, now}))
+            _dropped++;
+    }
+
+    int depth = (int)_queue.size();
+    if (depth > _maxQueueDepth)
+        _maxQueueDepth = depth;
+
+    // the lock is only taken when the audio thread is idle, so the
+    // notification can't arrive before it waits
+    if (_sleeping)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+        }
+        _wake.notify_one();
+    }
+}
+
+void AudioDispatcher::call(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(task));
+    }
+    _wake.notify_one();
+}
+
+AudioDispatcher::Metrics AudioDispatcher::getMetrics() const
+{
+    Metrics metrics;
+    metrics.posted = _posted;
+    metrics.coalesced = _coalesced;
+    metrics.dropped = _dropped;
+    metrics.played = _played;
+    metrics.maxQueueDepth = _maxQueueDepth;
+    metrics.averageLatency = metrics.played ? _totalLatency * 1e-9 / metrics.played : 0;
+    metrics.maxLatency = _maxLatency * 1e-9;
+    return metrics;
+}
+
+void AudioDispatcher::resetMetrics()
+{
+    _posted = 0;
+    _coalesced = 0;
+    _dropped = 0;
+    _maxQueueDepth = 0;
+    _played = 0;
+    _totalLatency = 0;
+    _maxLatency = 0;
+}
+
+void AudioDispatcher::run()
+{
+    std::vector<Task> tasks;
+    for (;;)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            tasks.swap(_tasks);
+        }
+        for (auto& task : tasks)
+            task();
+        tasks.clear();
+
+        Event event;
+        while (_queue.pop(event))
+        {
+            long long latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - event.flushed).count();
+            _totalLatency += latency;
+            if (latency > _maxLatency)
+                _maxLatency = latency;
+
+            PARKOUR_TRACE("playEffect");
+            _play(event.effect);
+            _played++;
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_quit && _queue.empty() && _tasks.empty())
+            break;
+        _sleeping = true;
+        if (_queue.empty() && _tasks.empty() && !_quit)
+            _wake.wait_for(lock, std::chrono::milliseconds(MAX_SLEEP_MS));
+        _sleeping = false;
+    }
+}
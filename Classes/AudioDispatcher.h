@@ -0,0 +1,121 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "SpscQueue.h"
+
+// Plays the sound effects on a thread of its own, so a slow audio
+// backend never stalls the game loop.
+//
+// The game thread posts effects during the frame and flushes them at
+// the end of it: an effect posted several times in the same frame (a
+// row of coins) is played once. The flushed effects go through a
+// lock-free queue to the audio thread, which calls the play function.
+// post() and flush() must be called from the same thread.
+//
+// Audio backends are usually not thread safe (SimpleAudioEngine isn't):
+// once the dispatcher plays through a backend, the audio thread must be
+// its only caller. Anything else, like preloading the effects, goes
+// through call().
+class AudioDispatcher
+{
+public:
+    // called from the audio thread
+    typedef std::function<void(int effect)> PlayFunction;
+    typedef std::function<void()> Task;
+
+    // effects are numbers in [0, MAX_EFFECTS)
+    static const int MAX_EFFECTS = 32;
+    // effects flushed but not played yet. More than that are dropped
+    static const int QUEUE_SIZE = 64;
+
+    struct Metrics
+    {
+        long long posted;               // calls to post()
+        long long coalesced;            // posted again in the same frame
+        long long dropped;              // the queue was full
+        long long played;
+        int maxQueueDepth;              // right after a flush
+        double averageLatency;          // from flush() to the play function, in seconds
+        double maxLatency;
+    };
+
+    explicit AudioDispatcher(PlayFunction play);
+    // runs the queued tasks and effects and stops the thread
+    ~AudioDispatcher();
+
+    // game thread
+    void post(int effect);
+    void flush();
+
+    // any thread. Runs 'task' on the audio thread, before the
+    // effects that are still in the queue
+    void call(Task task);
+
+    // any thread
+    Metrics getMetrics() const;
+    void resetMetrics();
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Event
+    {
+        int effect;
+        Clock::time_point flushed;
+    };
+
+    void run();
+
+    PlayFunction _play;
+    SpscQueue<Event, QUEUE_SIZE> _queue;
+    unsigned int _pending;              // effects posted in this frame, one bit each
+
+    // written by the game thread
+    std::atomic<long long> _posted;
+    std::atomic<long long> _coalesced;
+    std::atomic<long long> _dropped;
+    std::atomic<int> _maxQueueDepth;
+    // written by the audio thread
+    std::atomic<long long> _played;
+    std::atomic<long long> _totalLatency;   // nanoseconds
+    std::atomic<long long> _maxLatency;
+
+    // the audio thread sleeps while the queue is empty
+    std::mutex _mutex;
+    std::vector<Task> _tasks;           // guarded by _mutex
+    std::condition_variable _wake;
+    std::atomic<bool> _sleeping;
+    std::atomic<bool> _quit;
+    std::thread _thread;
+};
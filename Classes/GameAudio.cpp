@@ -0,0 +1,51 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "GameAudio.h"
+
+#include "audio/include/SimpleAudioEngine.h"
+
+// in SoundEffect order
+static const char* SOUND_EFFECT_FILES[] = {
+    "sfx/jump.mp3",
+    "sfx/pickup_coin.mp3",
+};
+static_assert(sizeof(SOUND_EFFECT_FILES)/sizeof(SOUND_EFFECT_FILES[0]) == SOUND_EFFECTS, "a file for every SoundEffect");
+
+AudioDispatcher* getGameAudio()
+{
+    static AudioDispatcher audio([](int effect){
+        CocosDenshion::SimpleAudioEngine::getInstance()->playEffect(SOUND_EFFECT_FILES[effect]);
+    });
+    return &audio;
+}
+
+void preloadSoundEffects()
+{
+    getGameAudio()->call([](){
+        auto engine = CocosDenshion::SimpleAudioEngine::getInstance();
+        for (auto file : SOUND_EFFECT_FILES)
+            engine->preloadEffect(file);
+    });
+}
@@ -25,24 +25,32 @@
 #include "GameNode.h"
 
 #include <stdio.h>
+#include <algorithm>
+#include <random>
 
+#include "AnimationRegistry.h"
+#include "GameAudio.h"
 #include "Map.h"
-#include "audio/include/SimpleAudioEngine.h"
+#include "Profiler.h"
+#include "ResourceLoader.h"
+#include "Tracer.h"
 
 using namespace cocos2d;
 
-static const float FOREGROUND_SPEED = 250;      // pixels per second
 static const float BACKGROUND_SPEED = 0.1;      // 10% of foreground speed
-static const float ACTOR_POS_Y = 60;
-static const float JUMP_VEL_Y = 4.5;
-static const float GRAVITY_Y = 2.5;
-static const float BUTTON_MAX_TIME = 0.4;       // max seconds that button can be pressed
-
-enum {
-    COIN = 0,
-    BOX = 1,
-    ANVIL = 2
-};
+static const float GROUND_SPEED = 1;
+
+// object quads allocated in advance.
+// Maps are streamed, so only the objects in the screen plus the spawn
+// look-ahead are alive at the same time: up to 28 coins (Get Ready map)
+// and ~30 boxes (map_4)
+static const int OBJECT_CAPACITY = 80;
+
+static const int COIN_FRAMES = AnimationRegistry::COIN_FRAMES;
+static const float COIN_FRAME_TIME = 0.05;
+
+static const int SCORE_DIGITS = 8;
+
 Scene* createSceneWithGame()
 {
     auto scene = Scene::create();
@@ -61,23 +69,41 @@ GameNode* GameNode::create()
     return node;
 }
 
+void GameNode::addResources(ResourceLoader* loader)
+{
+    loader->addImage("background00.png");
+    loader->addImage("background01.png");
+    loader->addImage("ground00.png");
+    loader->addImage("ground01.png");
+    loader->addImage("font_grinched_21.png");
+    loader->addSpriteFrames("parkour.plist");
+}
+
 GameNode::GameNode()
-: _buttonMode(RELEASED)
-, _elapsedTime(0)
-, _buttonPressedTime(0)
-, _gameSpeed(FOREGROUND_SPEED)
-, _elapsedPixels(0)
+: _audio(getGameAudio())
+, _parallax(nullptr)
+, _objects(nullptr)
+, _coinClock(0)
+, _coinTick(0)
+, _afterDrawListener(nullptr)
+, _drawStats(nullptr)
+, _drawCalls(0)
+, _maxDrawCalls(0)
+, _shownDrawCalls(-1)
+, _restartMenu(nullptr)
 {
+    // the dispatcher outlives the games: the metrics are per game
+    _audio->resetMetrics();
 }
 
 GameNode::~GameNode()
 {
+    if (_afterDrawListener)
+        Director::getInstance()->getEventDispatcher()->removeEventListener(_afterDrawListener);
+
     CC_SAFE_RELEASE(_runAction);
     CC_SAFE_RELEASE(_jumpDownAction);
     CC_SAFE_RELEASE(_jumpUpAction);
-
-    for (int i=0; i<8; i++)
-        CC_SAFE_RELEASE(_coinAnimation[i]);
 }
 
 bool GameNode::init()
@@ -85,36 +111,29 @@ bool GameNode::init()
     // assign size to node
     setContentSize(Director::getInstance()->getVisibleSize());
 
-    // set background images
-    // 2 sprites that will generate a fake "endless scroll"
-    _background0 = Sprite::create("background00.png");
-    _background1 = Sprite::create("background01.png");
-    _background0->setAnchorPoint(Vec2::ZERO);
-    _background1->setAnchorPoint(Vec2::ZERO);
-    addChild(_background0);
-    addChild(_background1);
-    // _background1 right after _background0
-    _background1->setPosition(Vec2(_background0->getContentSize().width,0));
-
-    // set ground images
-    // 2 sprites that will generate a fake "endless scroll"
-    _ground0 = Sprite::create("ground00.png");
-    _ground1 = Sprite::create("ground01.png");
-    _ground0->setAnchorPoint(Vec2::ZERO);
-    _ground1->setAnchorPoint(Vec2::ZERO);
-    addChild(_ground0);
-    addChild(_ground1);
-    // _ground1 right after _ground0
-    _ground1->setPosition(Vec2(_ground0->getContentSize().width,0));
+    // background and ground images generate a fake "endless scroll".
+    // The foreground and background move at different speeds
+    auto textureCache = Director::getInstance()->getTextureCache();
+    _parallax = ParallaxLayers::create();
+    _parallax->addLayer(textureCache->addImage("background00.png"), textureCache->addImage("background01.png"), BACKGROUND_SPEED);
+    _parallax->addLayer(textureCache->addImage("ground00.png"), textureCache->addImage("ground01.png"), GROUND_SPEED);
+    addChild(_parallax);
 
     initActorAnimation();
-    initCoinAnimation();
     initScore();
-
-    actorRun();
-
-    // initial game speed. How many pixels per second
-    _gameSpeed = FOREGROUND_SPEED;
+    initObjects();
+    initDrawStats();
+    initMapPack();
+    initRestartMenu();
+
+    // the simulation. It will call us back to create the
+    // "Get Ready" objects and to start the run animation
+    _world.setConfig(createWorldConfig());
+    _world.setDelegate(this);
+    _world.setJournal(&_journal);
+    _world.setSeed(std::random_device()());
+    _world.reset();
+    updateActor(1);
 
     // trigger main loop
     scheduleUpdate();
@@ -126,83 +145,111 @@ bool GameNode::init()
     listener->onTouchesEnded = CC_CALLBACK_2(GameNode::onTouchesEnded, this);
     eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
 
-    // Get Ready Map at the beginning of the level
-    auto map = getGetReadyMap();
-    addMap(map);
-
     return true;
 }
 
+static MapSize getFrameSize(AnimationRegistry::FrameId id)
+{
+    auto size = AnimationRegistry::getInstance()->getFrame(id)->getOriginalSize();
+    return {size.width, size.height};
+}
+
+World::Config GameNode::createWorldConfig() const
+{
+    // sizes are taken from parkour.plist
+    World::Config config;
+    config.screenWidth = Director::getInstance()->getVisibleSize().width;
+
+    config.actorSize[World::RUNNING] = getFrameSize(AnimationRegistry::FRAME_RUNNER0);
+    config.actorSize[World::JUMPING_UP] = getFrameSize(AnimationRegistry::FRAME_RUNNER_JUMP_UP0);
+    config.actorSize[World::JUMPING_DOWN] = getFrameSize(AnimationRegistry::FRAME_RUNNER_JUMP_UP0);
+    config.actorSize[World::CROUCH] = getFrameSize(AnimationRegistry::FRAME_RUNNER_CROUCH0);
+
+    config.objectSize[World::COIN] = getFrameSize(AnimationRegistry::FRAME_COIN0);
+    config.objectSize[World::BOX] = getFrameSize(AnimationRegistry::FRAME_BOX);
+    config.objectSize[World::ANVIL] = getFrameSize(AnimationRegistry::FRAME_ANVIL);
+    return config;
+}
+
 void GameNode::initScore()
 {
-    _score = Label::createWithCharMap("font_grinched_21.plist");
-    _score->setString(":::::0");
+    _score = NumericLabel::create("font_grinched_21.plist", SCORE_DIGITS);
     _score->setAnchorPoint(Vec2(1,1));
     addChild(_score);
     _score->setNormalizedPosition(Vec2(0.98,0.98));
 }
+void GameNode::initObjects()
+{
+    // all the frames of parkour.plist are in the same texture
+    auto registry = AnimationRegistry::getInstance();
+    auto texture = registry->getFrame(AnimationRegistry::FRAME_COIN0)->getTexture();
+    _objects = ObjectRenderer::create(texture, OBJECT_CAPACITY);
+    addChild(_objects);
+
+    // coins are animated by updateCoins()
+    for (int i=0; i<COIN_FRAMES; i++)
+        _coinFrames[i] = _objects->addFrame(registry->getFrame(AnimationRegistry::FrameId(AnimationRegistry::FRAME_COIN0 + i)));
+    _objectFrames[World::COIN] = _coinFrames[0];
+    _objectFrames[World::BOX] = _objects->addFrame(registry->getFrame(AnimationRegistry::FRAME_BOX));
+    _objectFrames[World::ANVIL] = _objects->addFrame(registry->getFrame(AnimationRegistry::FRAME_ANVIL));
+}
+
+void GameNode::initRestartMenu()
+{
+    // created once and shown at game over. A restart keeps the scene
+    auto item = MenuItemImage::create("restart_n.png", "restart_s.png");
+    _restartMenu = Menu::create(item, NULL);
+    // set callback for menu using C++11 lambda feature
+    item->setCallback([this](Ref* sender){
+        restart();
+    });
+    // center menu
+    _restartMenu->setNormalizedPosition(Vec2(0.5,0.8));
+    _restartMenu->setVisible(false);
+    addChild(_restartMenu);
+}
+
+void GameNode::initDrawStats()
+{
+    auto director = Director::getInstance();
+    if (!director->isDisplayStats())
+        return;
+
+    // the renderer resets its counters before the next frame
+    // is drawn, so they are read right after the draw
+    _afterDrawListener = director->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom* event){
+        _drawCalls = (int)Director::getInstance()->getRenderer()->getDrawnBatches();
+        _maxDrawCalls = std::max(_maxDrawCalls, _drawCalls);
+    });
+
+    _drawStats = Label::createWithSystemFont("draw calls: 0", "Arial", 10);
+    _drawStats->setAnchorPoint(Vec2(0,1));
+    addChild(_drawStats);
+    _drawStats->setNormalizedPosition(Vec2(0.02,0.98));
+}
+
+void GameNode::initMapPack()
+{
+    // made with tools/MapCompiler.cpp. Falls back to the built-in maps
+    _mapPackData = FileUtils::getInstance()->getDataFromFile("maps/maps.pkm");
+    if (!_mapPackData.isNull() && _mapPack.initWithData(_mapPackData.getBytes(), _mapPackData.getSize()))
+        _world.setMapPack(&_mapPack);
+    else
+        CCLOG("maps/maps.pkm not found or invalid. Using the built-in maps");
+}
+
 void GameNode::initActorAnimation()
 {
-    // add player animations for frame cache
-    auto frameCache = SpriteFrameCache::getInstance();
-    frameCache->addSpriteFramesWithFile("parkour.plist");
+    auto registry = AnimationRegistry::getInstance();
 
     // create main sprite
-    _actor = Sprite::createWithSpriteFrameName("runner0.png");
+    _actor = Sprite::createWithSpriteFrame(registry->getFrame(AnimationRegistry::FRAME_RUNNER0));
     _actor->setAnchorPoint(Vec2::ZERO);
-    _actor->setPosition(30,ACTOR_POS_Y);
     addChild(_actor);
 
-    // create the animations
-    const char* animRun[] = {
-        "runner0.png",
-        "runner1.png",
-        "runner2.png",
-        "runner3.png",
-        "runner4.png",
-        "runner5.png",
-        "runner6.png",
-        "runner7.png",
-    };
-    const int RUN_FRAMES = sizeof(animRun)/sizeof(animRun[0]);
-
-    const char* animJumpUp[] = {
-        "runnerJumpUp0.png",
-        "runnerJumpUp1.png",
-        "runnerJumpUp2.png",
-        "runnerJumpUp3.png",
-    };
-    const int JUMPUP_FRAMES = sizeof(animJumpUp)/sizeof(animJumpUp[0]);
-
-    const char* animJumpDown[] = {
-        "runnerJumpDown0.png",
-        "runnerJumpDown1.png",
-    };
-    const int JUMPDOWN_FRAMES = sizeof(animJumpDown)/sizeof(animJumpDown[0]);
-
-    Vector<SpriteFrame*> runFrames(RUN_FRAMES);
-    for (int i=0; i<RUN_FRAMES; i++)
-    {
-        auto frame = frameCache->getSpriteFrameByName(animRun[i]);
-        runFrames.pushBack(frame);
-    }
-    auto runAnimation = Animation::createWithSpriteFrames(runFrames, 0.1);
-
-    Vector<SpriteFrame*> jumpUpFrames(JUMPUP_FRAMES);
-    for (int i=0; i<JUMPUP_FRAMES; i++)
-    {
-        auto frame = frameCache->getSpriteFrameByName(animJumpUp[i]);
-        jumpUpFrames.pushBack(frame);
-    }
-    auto jumpUpAnimation = Animation::createWithSpriteFrames(jumpUpFrames, 0.02);
-
-    Vector<SpriteFrame*> jumpDownFrames(JUMPDOWN_FRAMES);
-    for (int i=0; i<JUMPDOWN_FRAMES; i++)
-    {
-        auto frame = frameCache->getSpriteFrameByName(animJumpUp[i]);
-        jumpDownFrames.pushBack(frame);
-    }
-    auto jumpDownAnimation = Animation::createWithSpriteFrames(jumpDownFrames, 0.2);
+    auto runAnimation = registry->getAnimation(AnimationRegistry::ANIMATION_RUN);
+    auto jumpUpAnimation = registry->getAnimation(AnimationRegistry::ANIMATION_JUMP_UP);
+    auto jumpDownAnimation = registry->getAnimation(AnimationRegistry::ANIMATION_JUMP_DOWN);
 
     // in order to animate the animation, we need to create an "Animate" action
     auto animate = Animate::create(runAnimation);
@@ -215,371 +262,195 @@ void GameNode::initActorAnimation()
     _jumpDownAction->retain();
 }
 
-void GameNode::initCoinAnimation()
+void GameNode::update(float dt)
 {
-    auto frameCache = SpriteFrameCache::getInstance();
-    const int COINS_FRAMES = 8;
-    for (int i=0; i<COINS_FRAMES; i++)
-    {
-        Vector<SpriteFrame*> coinsFrames(COINS_FRAMES);
-        for (int j=0; j<COINS_FRAMES; j++)
-        {
-            char buffer[40];
-            snprintf(buffer, sizeof(buffer)-1,"coin%d.png",(j+i)%8);
-            auto frame = frameCache->getSpriteFrameByName(buffer);
-            coinsFrames.pushBack(frame);
-        }
-        auto coinsAnimation = Animation::createWithSpriteFrames(coinsFrames, 0.05);
-        auto animateCoin = Animate::create(coinsAnimation);
-        _coinAnimation[i] = RepeatForever::create(animateCoin);
-        _coinAnimation[i]->retain();
-    }
+    PARKOUR_PROFILE(FRAME);
+    PARKOUR_TRACE("GameNode::update");
+
+    _world.advance(dt);
+    // the effects of this frame. A row of coins is a single effect
+    _audio->flush();
+
+    float alpha = _world.getInterpolationAlpha();
+    updateScroll(alpha);
+    updateActor(alpha);
+    updateObjects(alpha);
+    updateCoins(dt);
+    updateScore();
+    updateDrawStats();
 }
 
-void GameNode::update(float dt)
+void GameNode::updateScore()
 {
-    if (_actorMode != ActorMode::GAMEOVER)
-    {
-        _prevActorPos = _actor->getPosition();
-
-        // accelerate game
-        _gameSpeed += dt * 2;
-
-        processEvents(dt);
-        updateScroll(dt);
-        updateActor(dt);
-        updateObjects(dt);
-        updateScore(dt);
-        checkCollisions(dt);
-
-    }
+    // only the digits that changed are updated
+    _score->setValue(_world.getScore());
 }
-
-void GameNode::processEvents(float dt)
+void GameNode::updateDrawStats()
 {
-    if (_actorMode == ActorMode::RUNNING || _actorMode == ActorMode::CROUCH)
+    if (!_drawStats)
+        return;
+
+    // only when it changes, not to rebuild the label every frame
+    if (_shownDrawCalls != _drawCalls)
     {
-        if (_buttonMode == ButtonMode::PRESSED)
-        {
-            actorJump();
-            _buttonPressedTime = 0;
-        }
+        char buffer[40];
+        snprintf(buffer,sizeof(buffer)-1,"draw calls: %d",_drawCalls);
+        _drawStats->setString(buffer);
+        _shownDrawCalls = _drawCalls;
     }
 }
 
-void GameNode::updateScore(float dt)
+void GameNode::updateScroll(float alpha)
 {
-    _elapsedPixels += dt * _gameSpeed;
-
-    char buffer[40];
-    snprintf(buffer,sizeof(buffer)-1,"%d",_elapsedPixels);
-    _score->setString(buffer);
-}
-void GameNode::updateScroll(float dt)
-{
-    // foreground and background moves at different speed
-
-    //
-    // Foreground
-    //
-    float dx = dt * _gameSpeed;
-
-    // update ground
-    auto pos1 = _ground0->getPosition();
-    auto pos2 = _ground1->getPosition();
-    pos1.x -= dx;
-    pos2.x -= dx;
-
-    if (pos1.x < -_ground0->getContentSize().width)
-        pos1.x += _ground1->getContentSize().width * 2;
-    if (pos2.x < -_ground1->getContentSize().width)
-        pos2.x += _ground0->getContentSize().width * 2;
-
-    _ground0->setPosition(pos1);
-    _ground1->setPosition(pos2);
-
-    //
-    // Background
-    //
-    dx *= BACKGROUND_SPEED;
-
-    pos1 = _background0->getPosition();
-    pos2 = _background1->getPosition();
-    pos1.x -= dx;
-    pos2.x -= dx;
-
-    if (pos1.x < -_background0->getContentSize().width)
-        pos1.x += _background1->getContentSize().width * 2;
-    if (pos2.x < -_background1->getContentSize().width)
-        pos2.x += _background0->getContentSize().width * 2;
-
-    _background0->setPosition(pos1);
-    _background1->setPosition(pos2);
+    // the layers wrap around by themselves
+    _parallax->setScrollDistance(_world.getScrollDistance(alpha));
 }
 
-void GameNode::updateActor(float dt)
+void GameNode::updateActor(float alpha)
 {
-    if (_buttonMode == ButtonMode::PRESSED) {
-        _buttonPressedTime += dt;
-
-        if (_buttonPressedTime > BUTTON_MAX_TIME) {
-            _buttonMode = ButtonMode::RELEASED;
-        }
-    }
-
-    if (_actorMode==ActorMode::JUMPING_UP)
-    {
-        _accelTime += dt;
-
-        // reduce gravity while button is pressed
-        if (_buttonMode == ButtonMode::PRESSED)
-            _actorVel.y -= (GRAVITY_Y *0.01) * _accelTime;
-        else
-            _actorVel.y -= GRAVITY_Y * _accelTime;
-
-        Vec2 pos = _actor->getPosition();
-        pos.y += _actorVel.y;
-
-        // started going down ?
-        if (_actorVel.y <= 0)
-            actorGoDown();
-
-        _actor->setPosition(pos);
-    }
-    else if (_actorMode==ActorMode::JUMPING_DOWN)
-    {
-        _accelTime += dt;
-        _actorVel.y -= GRAVITY_Y * _accelTime;
-
-        Vec2 pos = _actor->getPosition();
-        pos.y += _actorVel.y;
-
-        if (pos.y <= ACTOR_POS_Y) {
-            pos.y = ACTOR_POS_Y;
-            if (_actorVel.y<-8)
-                actorCrouch();
-            else
-                actorRun();
-        }
-        _actor->setPosition(pos);
-    }
-    else if (_actorMode==ActorMode::CROUCH)
-    {
-        _elapsedTime += dt;
-        if (_elapsedTime >0.15)
-            actorRun();
-    }
+    auto pos = _world.getActorPosition(alpha);
+    _actor->setPosition(pos.x, pos.y);
 }
 
-void GameNode::updateObjects(float dt)
+void GameNode::updateObjects(float alpha)
 {
-    // 1 - scroll objects
-    float dx = dt * _gameSpeed;
-    for (Sprite* sprite: _objects)
-    {
-        auto pos = sprite->getPosition();
-        sprite->setPosition(pos.x-dx,pos.y);
-    }
-
-    // 2 - remove objects no longer visible
-    Vector<Sprite*> toRemove;
-
-    // objects are ordered in X
-    // if an object is still in the screen, it is safe
-    // to assume that the rest of the objects are still inside the
-    // screen too.
-    for (const auto& object: _objects)
-    {
-        auto& pos = object->getPosition();
-        auto& size = object->getContentSize();
-        if (pos.x+size.width+50 < 0)
-            toRemove.pushBack(object);
-        else
-            break;
-    }
-
-    for (const auto& object: toRemove)
-        _objects.eraseObject(object);
-
-    addObjects(dt);
+    // only X changes. Y was set when the object was added
+    auto& objects = _world.getObjects();
+    _objects->setX(objects.x.data(), objects.size(), _world.getObjectOffsetX(alpha));
 }
 
-void GameNode::checkCollisions(float dt)
+void GameNode::updateCoins(float dt)
 {
-    Vector<Sprite*> toRemove;
-
-    Rect actorBB = _actor->getBoundingBox();
-    // reduce BB by some pixels in X
-    actorBB.origin.x += 30;
-    actorBB.size.width -= 50;
-
-    bool collision = false;
-    // objects are sorted by their X position.
-    // the first object whose X positions is > actor.X + actor.with
-    // then, it is safe to stop the check
-    for(const auto& object: _objects)
+    _coinClock += dt;
+    int tick = (int)(_coinClock / COIN_FRAME_TIME);
+    if (tick == _coinTick)
+        return;
+    _coinTick = tick;
+
+    // all the coins change frame at the same time, in one pass
+    auto& objects = _world.getObjects();
+    for (int i=0; i<objects.size(); i++)
     {
-        Rect objbb = object->getBoundingBox();
-
-        if (actorBB.intersectsRect(objbb))
-        {
-            collision = true;
-            long objType = (long)object->getUserData();
-            if (objType == COIN) {
-                toRemove.pushBack(object);
-                CocosDenshion::SimpleAudioEngine::getInstance()->playEffect("sfx/pickup_coin.mp3");
-            }
-            else if (objType == BOX || objType == ANVIL)
-            {
-                // actor can run on top boxes, but a right collision is game over
-                // actor on top, and the collision is no bigger than 10 pixels
-                if ((objbb.origin.y + objbb.size.height - _prevActorPos.y) < 0)
-                {
-                    auto pos = _actor->getPosition();
-                    _actor->setPosition(pos.x,objbb.origin.y + objbb.size.height);
-                    actorRun();
-                }
-                else if (_actorVel.y==0 && (objbb.origin.y + objbb.size.height - actorBB.origin.y) == 0)
-                {
-                    // skip
-                }
-                else
-                {
-                    gameOver();
-                }
-            }
-        }
-    }
-
-    // running and no collision? and not on the ground ? then go down
-    if (!collision && _actorMode==ActorMode::RUNNING && actorBB.origin.y > ACTOR_POS_Y)
-        actorGoDown();
-
-    for (const auto& object: toRemove) {
-        removeChild(object);
-        _objects.eraseObject(object);
+        if (objects.type[i] == World::COIN && objects.alive[i])
+            _objects->setQuadFrame(i, getCoinFrame(i));
     }
 }
 
-void GameNode::onTouchesBegan(const std::vector<Touch*>& touches, Event* event)
+int GameNode::getCoinFrame(int index) const
 {
-    _buttonMode = ButtonMode::PRESSED;
+    // the phase is the map cell of the coin, so they don't spin in sync
+    auto& objects = _world.getObjects();
+    int phase = objects.column[index] + objects.row[index];
+    return _coinFrames[(phase + _coinTick) % COIN_FRAMES];
 }
 
-void GameNode::onTouchesEnded(const std::vector<Touch*>& touches, Event* event)
+void GameNode::onActorModeChanged(World::ActorMode mode)
 {
-    _buttonMode = ButtonMode::RELEASED;
+    switch (mode)
+    {
+        case World::RUNNING:
+            _actor->stopAllActions();
+            _actor->runAction(_runAction);
+            break;
+        case World::JUMPING_UP:
+            _actor->stopAllActions();
+            _actor->runAction(_jumpUpAction);
+            _audio->post(SFX_JUMP);
+            break;
+        case World::JUMPING_DOWN:
+            _actor->stopAllActions();
+            _actor->runAction(_jumpDownAction);
+            break;
+        case World::CROUCH:
+            _actor->stopAllActions();
+            _actor->setSpriteFrame(AnimationRegistry::getInstance()->getFrame(AnimationRegistry::FRAME_RUNNER_CROUCH0));
+            break;
+        case World::GAMEOVER:
+            gameOver();
+            break;
+    }
 }
 
-void GameNode::gameOver()
+void GameNode::onObjectAdded(int index)
 {
-    _actorMode = ActorMode::GAMEOVER;
-    _actor->stopAllActions();
-
-    auto item = MenuItemImage::create("restart_n.png", "restart_s.png");
-    auto menu = Menu::create(item, NULL);
-    // set callback for menu using C++11 lambda feature
-    item->setCallback([](Ref* sender){
-        Director::getInstance()->replaceScene(createSceneWithGame());
-    });
-    // center menu
-    menu->setNormalizedPosition(Vec2(0.5,0.8));
-    addChild(menu);
+    auto& objects = _world.getObjects();
+    int type = objects.type[index];
+    int frame = type == World::COIN ? getCoinFrame(index) : _objectFrames[type];
+    _objects->addQuad(frame, objects.x[index], objects.y[index]);
 }
 
-void GameNode::actorJump()
+void GameNode::onObjectKilled(int index)
 {
-    _actorMode = ActorMode::JUMPING_UP;
-    _actor->stopAllActions();
-    _actor->runAction(_jumpUpAction);
-    _actorVel = Vec2(0, JUMP_VEL_Y);          // pixels per seconds going up
-    _accelTime = 0;
-
-    CocosDenshion::SimpleAudioEngine::getInstance()->playEffect("sfx/jump.mp3");
+    _objects->hideQuad(index);
 }
 
-void GameNode::actorGoDown()
+void GameNode::onObjectsRemoved(int count)
 {
-    _actor->stopAllActions();
-    _actor->runAction(_jumpDownAction);
-    _actorMode = ActorMode::JUMPING_DOWN;
-    _accelTime = 0;
-    if (_actorVel.y >= 0) {
-        _actorVel.y = -3;
-    }
+    _objects->removeQuads(count);
 }
 
-void GameNode::actorRun()
+void GameNode::onCoinCollected()
 {
-    _actorMode = ActorMode::RUNNING;
-    _actor->stopAllActions();
-    _actor->runAction(_runAction);
-    _actorVel = Vec2::ZERO;
+    _audio->post(SFX_PICKUP_COIN);
 }
 
-void GameNode::actorCrouch()
+void GameNode::onTouchesBegan(const std::vector<Touch*>& touches, Event* event)
 {
-    _actor->stopAllActions();
-    _actorMode = ActorMode::CROUCH;
-    _actor->setSpriteFrame("runnerCrouch0.png");
-    _elapsedTime = 0;
-    _actorVel = Vec2::ZERO;
+    _world.setButtonPressed(true);
 }
 
-void GameNode::addObjects(float dt)
+void GameNode::onTouchesEnded(const std::vector<Touch*>& touches, Event* event)
 {
-    // if there are no more objects
-    // on the screen, then add more.
-    if (_objects.size()==0) {
-
-        auto map = getRandomMap();
-        addMap(map);
-    }
+    _world.setButtonPressed(false);
 }
 
-void GameNode::addMap(const ::Map* map)
+void GameNode::gameOver()
 {
-    for (int x=0; x<map->buffer_size.width; x++)
-    {
-        for (int y=0; y<map->buffer_size.height; y++)
-        {
-            int yy = map->buffer_size.height-y-1;
-            char c = map->buffer[y][x];
-            if (c=='C')
-                addCoin(x,yy,map->item_size);
-            else if (c=='B')
-                addBox(x,yy,map->item_size);
-            else if (c=='A')
-                addAnvil(x,yy,map->item_size);
-        }
-    }
-}
+    _actor->stopAllActions();
 
-void GameNode::addCoin(int x, int y, const Size& item_size)
-{
-    auto sprite = createObject(x, y, "coin0.png", item_size);
-    sprite->setUserData((void*)COIN);
-    sprite->runAction(_coinAnimation[(x+y)%8]->clone());
-}
-void GameNode::addBox(int x, int y, const Size& item_size)
-{
-    auto sprite = createObject(x, y, "box.png", item_size);
-    sprite->setUserData((void*)BOX);
-}
-void GameNode::addAnvil(int x, int y, const Size& item_size)
-{
-    auto sprite = createObject(x, y, "anvil.png", item_size);
-    sprite->setUserData((void*)ANVIL);
+    // it should never grow: OBJECT_CAPACITY is enough for any map
+    CCLOG("object quads: capacity %d, grown %d times", _objects->getCapacity(), _objects->getGrowCount());
+    auto audio = _audio->getMetrics();
+    CCLOG("sound effects: %lld posted, %lld coalesced, %lld dropped, max queue %d, latency %.2f ms (max %.2f ms)",
+          audio.posted, audio.coalesced, audio.dropped, audio.maxQueueDepth,
+          audio.averageLatency * 1000, audio.maxLatency * 1000);
+    if (_drawStats)
+        CCLOG("draw calls per frame: last %d, max %d", _drawCalls, _maxDrawCalls);
+
+    // replay it with: replay_journal last_run.journal --pack maps/maps.pkm
+    auto journalPath = FileUtils::getInstance()->getWritablePath() + "last_run.journal";
+    if (_journal.save(journalPath))
+        CCLOG("run journal (seed %u) written to %s", (unsigned int)_journal.getSeed(), journalPath.c_str());
+
+#ifdef PARKOUR_ENABLE_PROFILER
+    // timings of the last frames of the run
+    auto profiler = Profiler::getInstance();
+    auto path = FileUtils::getInstance()->getWritablePath();
+    profiler->dumpCSV(path + "profile.csv");
+    profiler->dumpJSON(path + "profile.json");
+    CCLOG("profile written to %sprofile.csv/.json", path.c_str());
+#endif
+
+    _restartMenu->setVisible(true);
 }
 
-Sprite* GameNode::createObject(int x, int y, const std::string& spriteName, const Size& item_size)
+void GameNode::restart()
 {
-    auto sprite = Sprite::createWithSpriteFrameName(spriteName);
-    sprite->setAnchorPoint(Vec2::ZERO);
-    addChild(sprite);
-    auto screenSize = Director::getInstance()->getVisibleSize();
-    sprite->setPosition(screenSize.width + x * item_size.width, ACTOR_POS_Y + y * item_size.height);
-
-    _objects.pushBack(sprite);
-    return sprite;
+    PARKOUR_TRACE("restart");
+    _restartMenu->setVisible(false);
+
+    // removes the objects of the last run through onObjectsRemoved()
+    // and starts the run animation through onActorModeChanged()
+    _world.setSeed(std::random_device()());
+    _world.reset();
+
+    _coinClock = 0;
+    _coinTick = 0;
+    _maxDrawCalls = 0;
+    _audio->resetMetrics();
+
+    updateScroll(1);
+    updateActor(1);
+    updateObjects(1);
+    updateScore();
 }
@@ -25,87 +25,99 @@
 #pragma once
 
 #include "cocos2d.h"
-#include "Map.h"
+#include "AudioDispatcher.h"
+#include "InputJournal.h"
+#include "NumericLabel.h"
+#include "ObjectRenderer.h"
+#include "ParallaxLayers.h"
+#include "World.h"
 
 cocos2d::Scene* createSceneWithGame();
 
-class GameNode : public cocos2d::Node
-{
-    enum ActorMode {
-        RUNNING,
-        JUMPING_UP,
-        JUMPING_DOWN,
-        CROUCH,
-        GAMEOVER
-    };
-
-    enum ButtonMode {
-        PRESSED,
-        RELEASED
-    };
+class ResourceLoader;
 
+// GameNode is a thin view of World: it steps the simulation
+// and interpolates the sprites from its state
+class GameNode : public cocos2d::Node, public World::Delegate
+{
 public:
     static GameNode* create();
     bool init();
 
+    // queues the images and sprite sheets used by init()
+    static void addResources(ResourceLoader* loader);
+
 protected:
     GameNode();
     virtual ~GameNode();
 
     void initActorAnimation();
-    void initCoinAnimation();
     void initScore();
+    void initObjects();
+    void initDrawStats();
+    void initMapPack();
+    void initRestartMenu();
+    World::Config createWorldConfig() const;
 
     virtual void update(float dt);
-    void updateScroll(float dt);
-    void updateActor(float dt);
-    void updateObjects(float dt);
-    void updateScore(float dt);
-    void checkCollisions(float dt);
-
-    void addObjects(float dt);
-    void addMap(const Map* map);
+    void updateScroll(float alpha);
+    void updateActor(float alpha);
+    void updateObjects(float alpha);
+    void updateCoins(float dt);
+    int getCoinFrame(int index) const;
+    void updateScore();
+    void updateDrawStats();
+
+    // World::Delegate
+    virtual void onActorModeChanged(World::ActorMode mode) override;
+    virtual void onObjectAdded(int index) override;
+    virtual void onObjectKilled(int index) override;
+    virtual void onObjectsRemoved(int count) override;
+    virtual void onCoinCollected() override;
 
     void onTouchesBegan(const std::vector<cocos2d::Touch*>& touches, cocos2d::Event* event);
     void onTouchesEnded(const std::vector<cocos2d::Touch*>& touches, cocos2d::Event* event);
-    void actorJump();
-    void actorGoDown();
-    void actorRun();
-    void actorCrouch();
     void gameOver();
-    void processEvents(float dt);
+    // starts a new run on the same nodes, animations and audio thread
+    void restart();
 
-    void addCoin(int x, int y, const cocos2d::Size& item_size);
-    void addBox(int x, int y, const cocos2d::Size& item_size);
-    void addAnvil(int x, int y, const cocos2d::Size& item_size);
-    cocos2d::Sprite* createObject(int x, int y, const std::string& spriteName, const cocos2d::Size& item_size);
+    World _world;
+    // inputs of the run, saved at game over so it can be replayed
+    InputJournal _journal;
+    // compiled maps. The world spawns from them when they are available
+    cocos2d::Data _mapPackData;
+    MapPack _mapPack;
+    // sound effects are played on the audio thread. Shared by all the games
+    AudioDispatcher* _audio;
 
-    // 2 images for the ground
-    cocos2d::Sprite* _ground0;
-    cocos2d::Sprite* _ground1;
-    // 2 images for the background
-    cocos2d::Sprite* _background0;
-    cocos2d::Sprite* _background1;
+    // background and ground, 2 images each
+    ParallaxLayers* _parallax;
 
     cocos2d::Action* _runAction;
     cocos2d::Action* _jumpUpAction;
     cocos2d::Action* _jumpDownAction;
 
-    cocos2d::Action* _coinAnimation[8];
-
-    cocos2d::Vector<cocos2d::Sprite*> _objects;
-    cocos2d::Label* _score;
-
-    int _elapsedPixels;                 // score will be based on this ivar
-    float _gameSpeed;
-    
-    float _buttonPressedTime;           // for how long the button was pressed
-    ButtonMode _buttonMode;             // pressed or released ?
+    // the objects of World::getObjects(), as quads with the same indices.
+    // All of them are rendered with one draw call
+    ObjectRenderer* _objects;
+    int _objectFrames[World::OBJECT_TYPES];
+    int _coinFrames[8];
+    // all the coins share the animation clock. Each one starts
+    // at a different frame, given by its map cell
+    double _coinClock;
+    int _coinTick;                      // frames of the animation played so far
+    NumericLabel* _score;
+
+    // draw calls of the last rendered frame, shown at the top left corner.
+    // The FPS stats of the director are at the bottom left one
+    cocos2d::EventListenerCustom* _afterDrawListener;
+    cocos2d::Label* _drawStats;
+    int _drawCalls;
+    int _maxDrawCalls;
+    int _shownDrawCalls;                // value in _drawStats
+
+    // hidden during the run
+    cocos2d::Menu* _restartMenu;
 
     cocos2d::Sprite* _actor;
-    ActorMode _actorMode;
-    cocos2d::Vec2 _actorVel;
-    cocos2d::Vec2 _prevActorPos;        // useful for collision detection
-    float _accelTime;
-    float _elapsedTime;                 // calculates elapsed time for crouch mode
 };
@@ -0,0 +1,168 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "InputJournal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+InputJournal::InputJournal()
+: _seed(1)
+, _packHash(0)
+, _steps(-1)
+, _score(-1)
+{
+}
+
+void InputJournal::start(uint32_t seed, const World::Config& config, uint64_t packHash)
+{
+    _seed = seed;
+    _config = config;
+    _packHash = packHash;
+    _entries.clear();
+    _steps = -1;
+    _score = -1;
+}
+
+void InputJournal::record(int step, bool pressed)
+{
+    _entries.push_back({step, pressed});
+}
+
+void InputJournal::finish(int steps, int score)
+{
+    _steps = steps;
+    _score = score;
+}
+
+bool InputJournal::save(const std::string& path) const
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+
+    fprintf(file, "parkour-journal %d\n", VERSION);
+    fprintf(file, "seed %u\n", (unsigned int)_seed);
+    fprintf(file, "pack %llx\n", (unsigned long long)_packHash);
+    // %.9g is enough for a float to read back the same
+    fprintf(file, "screen %.9g\n", _config.screenWidth);
+    fprintf(file, "actor");
+    for (auto& size : _config.actorSize)
+        fprintf(file, " %.9g %.9g", size.width, size.height);
+    fprintf(file, "\nobjects");
+    for (auto& size : _config.objectSize)
+        fprintf(file, " %.9g %.9g", size.width, size.height);
+    fprintf(file, "\n");
+    fprintf(file, "result %d %d\n", _steps, _score);
+    for (auto& entry : _entries)
+        fprintf(file, "%d %d\n", entry.step, entry.pressed ? 1 : 0);
+
+    return fclose(file) == 0;
+}
+
+// a line of the config: its name and 'count' sizes
+static bool readSizes(FILE* file, const char* name, MapSize* sizes, int count)
+{
+    char key[16];
+    if (fscanf(file, "%15s", key) != 1 || strcmp(key, name) != 0)
+        return false;
+    for (int i=0; i<count; i++)
+    {
+        if (fscanf(file, "%f %f", &sizes[i].width, &sizes[i].height) != 2)
+            return false;
+    }
+    return true;
+}
+
+bool InputJournal::load(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "r");
+    if (!file)
+        return false;
+
+    int version = 0;
+    unsigned int seed = 0;
+    unsigned long long packHash = 0;
+    World::Config config;
+    int steps = -1, score = -1;
+    bool ok = fscanf(file, "parkour-journal %d seed %u pack %llx screen %f", &version, &seed, &packHash, &config.screenWidth) == 4 && version == VERSION;
+    ok = ok && readSizes(file, "actor", config.actorSize, World::GAMEOVER);
+    ok = ok && readSizes(file, "objects", config.objectSize, World::OBJECT_TYPES);
+    ok = ok && fscanf(file, " result %d %d", &steps, &score) == 2;
+    if (!ok)
+    {
+        fclose(file);
+        return false;
+    }
+
+    start(seed, config, packHash);
+    int step, pressed;
+    while (fscanf(file, "%d %d", &step, &pressed) == 2)
+        record(step, pressed != 0);
+
+    ok = feof(file) != 0;
+    fclose(file);
+
+    finish(steps, score);
+    return ok;
+}
+
+bool InputJournal::hasSameMaps(const World& world) const
+{
+    auto pack = world.getMapPack();
+    return (pack ? pack->getHash() : 0) == _packHash;
+}
+
+bool InputJournal::replay(World& world) const
+{
+    if (!hasSameMaps(world))
+        return false;
+
+    // don't record the replay
+    auto journal = world.getJournal();
+    world.setJournal(nullptr);
+
+    // the config depends on the device that recorded the run
+    world.setConfig(_config);
+    world.setSeed(_seed);
+    world.reset();
+
+    // unfinished runs are played until the last input
+    int lastStep = isFinished() ? _steps : (_entries.empty() ? 0 : _entries.back().step);
+
+    size_t next = 0;
+    while (world.getActorMode() != World::GAMEOVER && world.getStepCount() < lastStep)
+    {
+        // inputs recorded in between two steps
+        while (next < _entries.size() && _entries[next].step == world.getStepCount())
+            world.setButtonPressed(_entries[next++].pressed);
+        world.step();
+    }
+
+    world.setJournal(journal);
+
+    if (!isFinished())
+        return true;
+    return world.getActorMode() == World::GAMEOVER && world.getStepCount() == _steps && world.getScore() == _score;
+}
@@ -0,0 +1,97 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "World.h"
+
+// The inputs of one run: its seed, the world config, the maps, plus
+// the button changes and the step they happened in. World is
+// deterministic, so that is all it takes to reproduce a run exactly.
+// replay() simulates it again headless, as fast as possible.
+//
+// Attach it with World::setJournal(): reset() starts the journal, button
+// changes are recorded and game over stores the result.
+//
+// Text format, so it can be attached to bug reports:
+//
+//   parkour-journal 2
+//   seed 1234
+//   pack 0                   <- MapPack::getHash(), 0 for the built-in maps
+//   screen 480               <- World::Config, it depends on the device
+//   actor 62 56 62 56 62 56 39 38      <- one size per ActorMode
+//   objects 36 36 56 44 56 44          <- one size per ObjectType
+//   result 2113 8801         <- steps and score. -1 -1 if the run didn't end
+//   0 1                      <- step, button pressed (1) or released (0)
+//   24 0
+class InputJournal
+{
+public:
+    struct Entry
+    {
+        int step;
+        bool pressed;
+    };
+
+    static const int VERSION = 2;
+
+    InputJournal();
+
+    // 'packHash' is the MapPack::getHash() of the maps, 0 for the built-in ones
+    void start(uint32_t seed, const World::Config& config, uint64_t packHash);
+    void record(int step, bool pressed);
+    void finish(int steps, int score);
+
+    uint32_t getSeed() const { return _seed; }
+    const World::Config& getConfig() const { return _config; }
+    uint64_t getPackHash() const { return _packHash; }
+    const std::vector<Entry>& getEntries() const { return _entries; }
+    bool isFinished() const { return _steps >= 0; }
+    int getSteps() const { return _steps; }
+    int getScore() const { return _score; }
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    // the maps of 'world' (built-in or pack) are the ones of the recording
+    bool hasSameMaps(const World& world) const;
+
+    // resets 'world' with the config and the seed of the journal and plays
+    // the recorded inputs, until game over or the recorded number of steps.
+    // Returns true if the run ends exactly as it was recorded.
+    // Returns false without playing if the maps are not the recorded ones
+    bool replay(World& world) const;
+
+protected:
+    uint32_t _seed;
+    World::Config _config;
+    uint64_t _packHash;
+    std::vector<Entry> _entries;
+    int _steps;
+    int _score;
+};
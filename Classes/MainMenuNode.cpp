@@ -23,12 +23,17 @@
  ****************************************************************************/
 
 #include "MainMenuNode.h"
+#include "AnimationRegistry.h"
+#include "GameAudio.h"
 #include "GameNode.h"
-
-#include "audio/include/SimpleAudioEngine.h"
+#include "ResourceLoader.h"
 
 using namespace cocos2d;
 
+// main thread time given to the ResourceLoader every frame, in seconds.
+// A third of a 60 fps frame
+static const float LOADER_BUDGET = 0.005;
+
 Scene* createSceneWithMainMenu()
 {
     // 'scene' is an autorelease object
@@ -56,6 +61,7 @@ MainMenuNode* MainMenuNode::create()
 }
 
 MainMenuNode::MainMenuNode()
+: _startPressed(false)
 {
 }
 
@@ -70,13 +76,18 @@ bool MainMenuNode::init()
     if ( !Node::init() )
         return false;
 
-    // play background music and preload effects
-    auto audio = CocosDenshion::SimpleAudioEngine::getInstance();
-//    audio->playBackgroundMusic("sfx/background.mp3", true);
-    audio->preloadEffect("sfx/jump.mp3");
-    audio->preloadEffect("sfx/pickup_coin.mp3");
-    audio->preloadEffect("sfx/crouch.mp3");
+    // preload effects. On the audio thread, the only one that
+    // calls SimpleAudioEngine
+    preloadSoundEffects();
 
+    // decode the game resources while the menu is shown
+    auto loader = ResourceLoader::getInstance();
+    if (!loader->isStarted())
+    {
+        GameNode::addResources(loader);
+        loader->start();
+    }
+    scheduleUpdate();
 
     // nodes has a default size of (0,0).
     // in order to use setNormalizedPosition correctly, we should set a size
@@ -104,8 +115,9 @@ bool MainMenuNode::init()
     auto menu = Menu::create(item, NULL);
 
     // set callback for menu using C++11 lambda feature
-    item->setCallback([](Ref* sender){
-        Director::getInstance()->replaceScene(createSceneWithGame());
+    // the scene is replaced in update(), when the resources are ready
+    item->setCallback([this](Ref* sender){
+        _startPressed = true;
     });
 
     // center menu
@@ -118,3 +130,20 @@ bool MainMenuNode::init()
     return true;
 }
 
+void MainMenuNode::update(float dt)
+{
+    auto loader = ResourceLoader::getInstance();
+    loader->update(LOADER_BUDGET);
+
+    if (!loader->isReady())
+        return;
+
+    // built once, while the menu waits, not when the game starts
+    AnimationRegistry::getInstance();
+
+    if (_startPressed)
+    {
+        _startPressed = false;
+        Director::getInstance()->replaceScene(createSceneWithGame());
+    }
+}
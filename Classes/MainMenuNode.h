@@ -37,4 +37,9 @@ public:
 protected:
     MainMenuNode();
     virtual ~MainMenuNode();
+
+    virtual void update(float dt);
+
+    // the game starts once its resources are loaded
+    bool _startPressed;
 };
@@ -163,8 +163,60 @@ const Map* getGetReadyMap()
     return &map_getReady;
 }
 
-const Map* getRandomMap()
+int getMapCount()
 {
-    int idx = CCRANDOM_0_1() * TOTAL_MAPS;
-    return maps[idx];
+    return TOTAL_MAPS;
+}
+
+const Map* getMap(int index)
+{
+    return maps[index];
+}
+
+// entities of the Get Ready map, then of the random maps
+static const std::vector<std::vector<MapEntity>>& getEntityTable()
+{
+    static const std::vector<std::vector<MapEntity>> table = []() {
+        std::vector<std::vector<MapEntity>> entities(TOTAL_MAPS + 1);
+        compileMap(&map_getReady, entities[0]);
+        for (int i=0; i<TOTAL_MAPS; i++)
+            compileMap(maps[i], entities[i + 1]);
+        return entities;
+    }();
+    return table;
+}
+
+const std::vector<MapEntity>& getGetReadyEntities()
+{
+    return getEntityTable()[0];
+}
+
+const std::vector<MapEntity>& getMapEntities(int index)
+{
+    return getEntityTable()[index + 1];
+}
+
+void compileMap(const Map* map, std::vector<MapEntity>& entities)
+{
+    for (int x=0; x<map->buffer_size.width; x++)
+    {
+        for (int y=0; y<map->buffer_size.height; y++)
+        {
+            int yy = map->buffer_size.height-y-1;
+            char c = map->buffer[y][x];
+
+            // same values as World::ObjectType.
+            // 'b' and 'a' are the right half of boxes and anvils
+            MapEntity entity = {(unsigned short)x, (unsigned char)yy, 0};
+            if (c=='C')
+                entity.type = 0;
+            else if (c=='B')
+                entity.type = 1;
+            else if (c=='A')
+                entity.type = 2;
+            else
+                continue;
+            entities.push_back(entity);
+        }
+    }
 }
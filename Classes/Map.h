@@ -24,15 +24,44 @@
 
 #pragma once
 
-// needed for cocos2d::Size
-#include "cocos2d.h"
+#include <vector>
+
+// Maps don't depend on cocos2d: they are shared with the headless
+// World simulation
+struct MapSize
+{
+    float width;
+    float height;
+};
+
+// A map object already resolved from the grid:
+// cell, counting rows from the bottom, and World::ObjectType
+struct MapEntity
+{
+    unsigned short column;
+    unsigned char row;
+    unsigned char type;
+};
 
 struct Map
 {
     const char** buffer;
-    cocos2d::Size buffer_size;
-    cocos2d::Size item_size;
+    MapSize buffer_size;
+    MapSize item_size;
 };
 
 const Map* getGetReadyMap();
-const Map* getRandomMap();
+
+// random maps, without the Get Ready one
+int getMapCount();
+const Map* getMap(int index);
+
+// the objects of the built-in maps, in spawn order. Built the first
+// time they are needed, so spawning a map again costs O(entities)
+// instead of O(cells). Thread safe.
+const std::vector<MapEntity>& getGetReadyEntities();
+const std::vector<MapEntity>& getMapEntities(int index);
+
+// appends the objects of the grid to 'entities', in spawn order:
+// column by column, from the top row to the bottom one
+void compileMap(const Map* map, std::vector<MapEntity>& entities);
@@ -0,0 +1,223 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "MapPack.h"
+#include "World.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PARKOUR_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(MapEntity) == 4, "MapEntity is part of the file format");
+static_assert(sizeof(MapPack::Header) == 12, "MapPack::Header is part of the file format");
+static_assert(sizeof(MapPack::MapHeader) == 20, "MapPack::MapHeader is part of the file format");
+
+static const char MAGIC[4] = {'P', 'K', 'M', 'P'};
+
+MapPack::MapPack()
+: _header(nullptr)
+, _maps(nullptr)
+, _entities(nullptr)
+, _hash(0)
+, _mapped(nullptr)
+, _mappedSize(0)
+{
+}
+
+MapPack::~MapPack()
+{
+    release();
+}
+
+void MapPack::release()
+{
+#if PARKOUR_HAS_MMAP
+    if (_mapped)
+        munmap(_mapped, _mappedSize);
+#endif
+    _mapped = nullptr;
+    _mappedSize = 0;
+    _buffer.clear();
+
+    _header = nullptr;
+    _maps = nullptr;
+    _entities = nullptr;
+    _hash = 0;
+}
+
+bool MapPack::initWithData(const void* data, size_t size)
+{
+    auto bytes = static_cast<const char*>(data);
+
+    if (size < sizeof(Header))
+        return false;
+
+    auto header = reinterpret_cast<const Header*>(bytes);
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION)
+        return false;
+
+    // World::reset() always starts with map 0
+    if (header->mapCount == 0 || header->mapCount > MAX_MAPS ||
+        header->mapCount > (size - sizeof(Header)) / sizeof(MapHeader))
+        return false;
+    size_t mapsSize = header->mapCount * sizeof(MapHeader);
+
+    auto maps = reinterpret_cast<const MapHeader*>(bytes + sizeof(Header));
+    auto entities = reinterpret_cast<const MapEntity*>(bytes + sizeof(Header) + mapsSize);
+    size_t entityCount = (size - sizeof(Header) - mapsSize) / sizeof(MapEntity);
+    for (unsigned int i=0; i<header->mapCount; i++)
+    {
+        const MapHeader& map = maps[i];
+        // written so that a crafted header can't overflow the sum
+        if (map.firstEntity > entityCount || entityCount - map.firstEntity < map.entityCount)
+            return false;
+        // the negated tests reject NaN too
+        if (!(map.itemWidth > 0) || !(map.itemHeight > 0))
+            return false;
+        if (map.columns > MAX_COLUMNS || map.rows > MAX_ROWS)
+            return false;
+
+        // World::addObject() indexes Config::objectSize[] with the type,
+        // and relies on the column order to keep the objects sorted by X
+        int previousColumn = 0;
+        for (unsigned int j=map.firstEntity; j<map.firstEntity + map.entityCount; j++)
+        {
+            const MapEntity& entity = entities[j];
+            if (entity.type >= World::OBJECT_TYPES || entity.column >= map.columns ||
+                entity.row >= map.rows || entity.column < previousColumn)
+                return false;
+            previousColumn = entity.column;
+        }
+    }
+
+    // recorded by the run journals, so a replay can tell it uses the same maps
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i=0; i<size; i++)
+        hash = (hash ^ (unsigned char)bytes[i]) * 1099511628211ULL;
+
+    _header = header;
+    _maps = maps;
+    _hash = hash;
+    _entities = entities;
+    return true;
+}
+
+bool MapPack::initWithFile(const std::string& path)
+{
+    release();
+
+#if PARKOUR_HAS_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED)
+        {
+            _mapped = mapped;
+            _mappedSize = st.st_size;
+        }
+    }
+    close(fd);
+
+    if (_mapped)
+    {
+        if (initWithData(_mapped, _mappedSize))
+            return true;
+        release();
+        return false;
+    }
+#endif
+
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    char chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        _buffer.insert(_buffer.end(), chunk, chunk + read);
+    fclose(file);
+
+    if (initWithData(_buffer.data(), _buffer.size()))
+        return true;
+    release();
+    return false;
+}
+
+CompiledMap MapPack::getMap(int index) const
+{
+    const MapHeader& map = _maps[index];
+    CompiledMap compiled = {
+        _entities + map.firstEntity,
+        (int)map.entityCount,
+        {(float)map.columns, (float)map.rows},
+        {map.itemWidth, map.itemHeight}
+    };
+    return compiled;
+}
+
+bool MapPack::writeFile(const std::string& path, const std::vector<const Map*>& maps)
+{
+    Header header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.mapCount = (unsigned int)maps.size();
+
+    std::vector<MapHeader> mapHeaders;
+    std::vector<MapEntity> entities;
+    for (auto map: maps)
+    {
+        MapHeader mapHeader;
+        mapHeader.firstEntity = (unsigned int)entities.size();
+        compileMap(map, entities);
+        mapHeader.entityCount = (unsigned int)entities.size() - mapHeader.firstEntity;
+        mapHeader.columns = (unsigned short)map->buffer_size.width;
+        mapHeader.rows = (unsigned short)map->buffer_size.height;
+        mapHeader.itemWidth = map->item_size.width;
+        mapHeader.itemHeight = map->item_size.height;
+        mapHeaders.push_back(mapHeader);
+    }
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && !mapHeaders.empty())
+        ok = fwrite(mapHeaders.data(), sizeof(MapHeader), mapHeaders.size(), file) == mapHeaders.size();
+    if (ok && !entities.empty())
+        ok = fwrite(entities.data(), sizeof(MapEntity), entities.size(), file) == entities.size();
+    return fclose(file) == 0 && ok;
+}
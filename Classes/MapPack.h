@@ -0,0 +1,111 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "Map.h"
+
+// A compiled map: the objects are already resolved, so spawning
+// it is a linear copy of its entities
+struct CompiledMap
+{
+    const MapEntity* entities;
+    int entityCount;
+    MapSize buffer_size;
+    MapSize item_size;
+};
+
+// Maps compiled offline by tools/MapCompiler.cpp.
+//
+// Binary format, little endian, every section 4-byte aligned:
+//
+//   Header      magic "PKMP", version, number of maps
+//   MapHeader   one per map: first entity, number of entities,
+//               columns, rows, item width and height
+//   MapEntity   the entities of all the maps, in spawn order
+//
+// The data is used in place (memory mapped when possible):
+// loading checks the bounds and the object types, but doesn't
+// parse nor copy anything.
+// The first map of a pack is the "Get Ready" map. The entities of a
+// map are sorted by column, inside the map's columns and rows.
+class MapPack
+{
+public:
+    struct Header
+    {
+        char magic[4];
+        unsigned int version;
+        unsigned int mapCount;
+    };
+
+    struct MapHeader
+    {
+        unsigned int firstEntity;
+        unsigned int entityCount;
+        unsigned short columns;
+        unsigned short rows;
+        float itemWidth;
+        float itemHeight;
+    };
+
+    static const unsigned int VERSION = 1;
+    // limits of ObjectStore: the map index is an unsigned char,
+    // the column a short. Rows fit MapEntity::row
+    static const unsigned int MAX_MAPS = 256;
+    static const unsigned int MAX_COLUMNS = 32767;
+    static const unsigned int MAX_ROWS = 256;
+
+    MapPack();
+    ~MapPack();
+
+    // 'data' must outlive the pack
+    bool initWithData(const void* data, size_t size);
+    // memory maps the file when the platform supports it, reads it otherwise
+    bool initWithFile(const std::string& path);
+
+    int getMapCount() const { return _header ? (int)_header->mapCount : 0; }
+    // identifies the contents of the pack: 64-bit FNV-1a of the whole file
+    uint64_t getHash() const { return _hash; }
+    CompiledMap getMap(int index) const;
+
+    // compiles the grids and writes them as a pack
+    static bool writeFile(const std::string& path, const std::vector<const Map*>& maps);
+
+protected:
+    void release();
+
+    const Header* _header;
+    const MapHeader* _maps;
+    const MapEntity* _entities;
+    uint64_t _hash;
+
+    void* _mapped;                      // memory mapped file, if any
+    size_t _mappedSize;
+    std::vector<char> _buffer;          // file contents when it can't be mapped
+};
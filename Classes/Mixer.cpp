@@ -0,0 +1,194 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Mixer.h"
+
+#include <limits.h>
+#include <string.h>
+#include <algorithm>
+
+const int Mixer::MAX_VOICES;
+const int Mixer::BLOCK_FRAMES;
+
+Mixer::Mixer(int sampleRate)
+: _sampleRate(sampleRate)
+, _activeVoices(0)
+, _dropped(0)
+, _played(0)
+, _stolen(0)
+, _mixedFrames(0)
+, _maxActiveVoices(0)
+, _totalLatency(0)
+, _maxLatency(0)
+{
+}
+
+int Mixer::addSound(const int16_t* samples, int frames, int channels, int sampleRate)
+{
+    if (sampleRate <= 0 || channels <= 0 || frames < 0 || (frames > 0 && !samples))
+        return -1;
+    // the sounds are indexed with ints in _pcm
+    long long length = (long long)frames * _sampleRate / sampleRate;
+    if (length > INT_MAX - (long long)_pcm.size())
+        return -1;
+
+    // to mono float
+    std::vector<float> mono(frames);
+    for (int i=0; i<frames; i++)
+    {
+        float sum = 0;
+        for (int c=0; c<channels; c++)
+            sum += samples[i * channels + c];
+        mono[i] = sum / (channels * 32768.0f);
+    }
+
+    // to the mixer rate, linear interpolation
+    Sound sound = {(int)_pcm.size(), (int)length};
+    _pcm.resize(_pcm.size() + length);
+    float* out = &_pcm[sound.start];
+    double step = (double)sampleRate / _sampleRate;
+    for (int i=0; i<length; i++)
+    {
+        double position = i * step;
+        int index = (int)position;
+        float t = (float)(position - index);
+        float next = index + 1 < frames ? mono[index + 1] : mono[index];
+        out[i] = mono[index] + (next - mono[index]) * t;
+    }
+
+    _sounds.push_back(sound);
+    return (int)_sounds.size() - 1;
+}
+
+bool Mixer::play(int sound, float gain)
+{
+    // the sounds are all added before mixing starts: reading their count is safe
+    if (sound < 0 || sound >= (int)_sounds.size())
+        return false;
+    if (_commands.push({sound, gain, Clock::now()}))
+        return true;
+    _dropped++;
+    return false;
+}
+
+void Mixer::mix(float* out, int frames)
+{
+    startVoices();
+    for (int done=0; done<frames; done+=BLOCK_FRAMES)
+        mixBlock(out + done, std::min(BLOCK_FRAMES, frames - done));
+    _mixedFrames += frames;
+}
+
+void Mixer::mix(int16_t* out, int frames)
+{
+    startVoices();
+    for (int done=0; done<frames; done+=BLOCK_FRAMES)
+    {
+        int count = std::min(BLOCK_FRAMES, frames - done);
+        mixBlock(_block, count);
+        int16_t* block = out + done;
+        for (int i=0; i<count; i++)
+            block[i] = (int16_t)std::max(-32768.0f, std::min(32767.0f, _block[i] * 32768.0f));
+    }
+    _mixedFrames += frames;
+}
+
+Mixer::Metrics Mixer::getMetrics() const
+{
+    Metrics metrics;
+    metrics.played = _played;
+    metrics.stolen = _stolen;
+    metrics.dropped = _dropped;
+    metrics.mixedFrames = _mixedFrames;
+    metrics.maxActiveVoices = _maxActiveVoices;
+    metrics.averageLatency = metrics.played ? _totalLatency * 1e-9 / metrics.played : 0;
+    metrics.maxLatency = _maxLatency * 1e-9;
+    return metrics;
+}
+
+void Mixer::startVoices()
+{
+    Command command;
+    while (_commands.pop(command))
+    {
+        long long latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - command.posted).count();
+        _totalLatency += latency;
+        if (latency > _maxLatency)
+            _maxLatency = latency;
+        if (_sounds[command.sound].length == 0)
+            continue;
+
+        int voice = _activeVoices;
+        if (voice == MAX_VOICES)
+        {
+            // the one that has played for longer
+            voice = (int)(std::max_element(_voicePosition, _voicePosition + MAX_VOICES) - _voicePosition);
+            _stolen++;
+        }
+        else
+        {
+            _activeVoices++;
+        }
+        _voiceSound[voice] = command.sound;
+        _voicePosition[voice] = 0;
+        _voiceGain[voice] = command.gain;
+        _played++;
+    }
+
+    if (_activeVoices > _maxActiveVoices)
+        _maxActiveVoices = _activeVoices;
+}
+
+void Mixer::mixBlock(float* out, int frames)
+{
+    memset(out, 0, sizeof(float) * frames);
+
+    for (int voice=0; voice<_activeVoices; )
+    {
+        auto& sound = _sounds[_voiceSound[voice]];
+        int position = _voicePosition[voice];
+        int count = std::min(frames, sound.length - position);
+
+        // contiguous multiply-add, vectorized by the compiler
+        const float* in = &_pcm[sound.start + position];
+        float gain = _voiceGain[voice];
+        for (int i=0; i<count; i++)
+            out[i] += in[i] * gain;
+
+        position += count;
+        if (position < sound.length)
+        {
+            _voicePosition[voice] = position;
+            voice++;
+        }
+        else
+        {
+            // finished: the last active voice takes its place
+            _activeVoices--;
+            _voiceSound[voice] = _voiceSound[_activeVoices];
+            _voicePosition[voice] = _voicePosition[_activeVoices];
+            _voiceGain[voice] = _voiceGain[_activeVoices];
+        }
+    }
+}
@@ -0,0 +1,127 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "SpscQueue.h"
+
+// Software mixer for the sound effects.
+//
+// The sounds are decoded once, up front, to mono float PCM at the mixer
+// rate, and kept one after the other in a single buffer. A fixed pool of
+// voices plays them: mixing a voice is a multiply-add over two contiguous
+// float arrays, which compilers vectorize. Nothing is allocated nor
+// locked while mixing.
+//
+// play() is called from one thread (the AudioDispatcher one) and mix()
+// from another one (the audio callback, or a WavWriter headless): the
+// voices are started through a lock-free queue at the next mix().
+class Mixer
+{
+public:
+    static const int MAX_VOICES = 16;
+    // mix() works in blocks of this many frames
+    static const int BLOCK_FRAMES = 512;
+
+    struct Metrics
+    {
+        long long played;               // voices started
+        long long stolen;               // all the voices were busy: the oldest one was reused
+        long long dropped;              // the queue of play() was full
+        long long mixedFrames;
+        int maxActiveVoices;
+        double averageLatency;          // from play() to the mix() that starts the voice, in seconds
+        double maxLatency;
+    };
+
+    explicit Mixer(int sampleRate = 44100);
+
+    int getSampleRate() const { return _sampleRate; }
+
+    // adds a sound from interleaved 16 bits PCM. It is converted to mono
+    // at the mixer rate. Must be called before mixing starts.
+    // Returns the id of the sound, or -1 if the arguments are not valid
+    int addSound(const int16_t* samples, int frames, int channels, int sampleRate);
+    int getSoundCount() const { return (int)_sounds.size(); }
+    // in frames of the mixer
+    int getSoundLength(int sound) const { return _sounds[sound].length; }
+
+    // starts 'sound' in the next mix(). False if the id is not valid
+    // or the queue is full
+    bool play(int sound, float gain = 1);
+
+    // mixes the next 'frames' mono frames of the playing voices
+    void mix(float* out, int frames);
+    // the same, clamped to 16 bits
+    void mix(int16_t* out, int frames);
+
+    int getActiveVoices() const { return _activeVoices; }
+    Metrics getMetrics() const;
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Sound
+    {
+        int start;                      // in _pcm
+        int length;
+    };
+
+    struct Command
+    {
+        int sound;
+        float gain;
+        Clock::time_point posted;
+    };
+
+    void startVoices();
+    void mixBlock(float* out, int frames);
+
+    int _sampleRate;
+    std::vector<float> _pcm;            // all the sounds
+    std::vector<Sound> _sounds;
+    SpscQueue<Command, 64> _commands;
+
+    // the voices as a structure of arrays. The first _activeVoices are playing
+    int _voiceSound[MAX_VOICES];
+    int _voicePosition[MAX_VOICES];
+    float _voiceGain[MAX_VOICES];
+    int _activeVoices;
+    float _block[BLOCK_FRAMES];         // for mix(int16_t*)
+
+    // written by the thread of play()
+    std::atomic<long long> _dropped;
+    // written by the thread of mix()
+    std::atomic<long long> _played;
+    std::atomic<long long> _stolen;
+    std::atomic<long long> _mixedFrames;
+    std::atomic<int> _maxActiveVoices;
+    std::atomic<long long> _totalLatency;   // nanoseconds
+    std::atomic<long long> _maxLatency;
+};
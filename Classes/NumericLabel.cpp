@@ -0,0 +1,105 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "NumericLabel.h"
+
+using namespace cocos2d;
+
+NumericLabel* NumericLabel::create(const std::string& charMapFile, int slots)
+{
+    auto node = new (std::nothrow) NumericLabel();
+    if (node && node->init(charMapFile, slots))
+    {
+        node->autorelease();
+        return node;
+    }
+    CC_SAFE_DELETE(node);
+    return nullptr;
+}
+
+NumericLabel::NumericLabel()
+: _glyphs(nullptr)
+{
+}
+
+NumericLabel::~NumericLabel()
+{
+}
+
+bool NumericLabel::init(const std::string& charMapFile, int slots)
+{
+    if (!Node::init())
+        return false;
+
+    // same format as Label::setCharMap(). The item size is in pixels
+    auto fileUtils = FileUtils::getInstance();
+    auto path = fileUtils->fullPathForFilename(charMapFile);
+    auto dict = fileUtils->getValueMapFromFile(path);
+    if (dict.empty() || dict["version"].asInt() != 1)
+    {
+        CCLOG("NumericLabel: invalid char map %s", charMapFile.c_str());
+        return false;
+    }
+    auto textureFile = path.substr(0, path.find_last_of("/") + 1) + dict["textureFilename"].asString();
+    auto texture = Director::getInstance()->getTextureCache()->addImage(textureFile);
+    if (!texture)
+        return false;
+
+    int itemWidth = dict["itemWidth"].asInt();
+    int itemHeight = dict["itemHeight"].asInt();
+    int firstChar = dict["firstChar"].asInt();
+    int itemsPerRow = texture->getPixelsWide() / itemWidth;
+
+    _glyphs = ObjectRenderer::create(texture, slots);
+    addChild(_glyphs);
+    for (int i=0; i<10; i++)
+    {
+        int item = '0' + i - firstChar;
+        Rect rect((item % itemsPerRow) * itemWidth, (item / itemsPerRow) * itemHeight, itemWidth, itemHeight);
+        _digitFrames[i] = _glyphs->addFrame(SpriteFrame::createWithTexture(texture, CC_RECT_PIXELS_TO_POINTS(rect)));
+    }
+
+    // one quad per slot, hidden until it has a digit
+    _text = NumericText(slots);
+    Size itemSize = CC_SIZE_PIXELS_TO_POINTS(Size(itemWidth, itemHeight));
+    for (int i=0; i<_text.getSlotCount(); i++)
+        _glyphs->addQuad(-1, i * itemSize.width, 0);
+    setContentSize(Size(itemSize.width * _text.getSlotCount(), itemSize.height));
+
+    setValue(0);
+    return true;
+}
+
+void NumericLabel::setValue(int value)
+{
+    unsigned int changed = _text.setValue(value);
+    for (int slot=0; changed; slot++, changed >>= 1)
+    {
+        if (changed & 1)
+        {
+            int digit = _text.getDigit(slot);
+            _glyphs->setQuadFrame(slot, digit == NumericText::BLANK ? -1 : _digitFrames[digit]);
+        }
+    }
+}
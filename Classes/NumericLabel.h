@@ -0,0 +1,55 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <string>
+
+#include "cocos2d.h"
+#include "NumericText.h"
+#include "ObjectRenderer.h"
+
+// Label for a number that changes every frame, like the score.
+// One glyph quad per slot of NumericText: setValue() only rewrites the
+// quads of the digits that changed, and doesn't allocate.
+// Unlike Label::setString() nothing is formatted nor laid out again.
+class NumericLabel : public cocos2d::Node
+{
+public:
+    // 'charMapFile' is a char map plist, like the ones of
+    // Label::createWithCharMap(). Only the digits are used
+    static NumericLabel* create(const std::string& charMapFile, int slots);
+    bool init(const std::string& charMapFile, int slots);
+
+    void setValue(int value);
+    int getValue() const { return _text.getValue(); }
+
+protected:
+    NumericLabel();
+    virtual ~NumericLabel();
+
+    NumericText _text;
+    ObjectRenderer* _glyphs;
+    int _digitFrames[10];               // ObjectRenderer frames of '0' to '9'
+};
@@ -0,0 +1,61 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "NumericText.h"
+
+NumericText::NumericText(int slots)
+: _slots(slots < 1 ? 1 : (slots > MAX_SLOTS ? MAX_SLOTS : slots))
+, _value(-1)
+{
+    for (int i=0; i<MAX_SLOTS; i++)
+        _digits[i] = BLANK;
+}
+
+unsigned int NumericText::setValue(int value)
+{
+    if (value < 0)
+        value = 0;
+    if (value == _value)
+        return 0;
+    _value = value;
+
+    // from right to left. The last slot always has a digit, even for 0
+    unsigned int changed = 0;
+    unsigned int remaining = (unsigned int)value;
+    for (int slot=_slots-1; slot>=0; slot--)
+    {
+        signed char digit = BLANK;
+        if (remaining || slot == _slots-1)
+        {
+            digit = (signed char)(remaining % 10);
+            remaining /= 10;
+        }
+        if (_digits[slot] != digit)
+        {
+            _digits[slot] = digit;
+            changed |= 1u << slot;
+        }
+    }
+    return changed;
+}
@@ -0,0 +1,55 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+// The decimal digits of a number in a fixed number of slots, right
+// aligned, for labels that change every frame like the score.
+// It remembers the digits of the previous value, so a label only has to
+// redraw the slots that changed. No snprintf, no strings, no allocations.
+class NumericText
+{
+public:
+    // enough for any int
+    static const int MAX_SLOTS = 10;
+    // digit of the slots on the left of the number
+    static const int BLANK = -1;
+
+    explicit NumericText(int slots = MAX_SLOTS);
+
+    // returns a mask with a bit per slot that changed: bit 0 is slot 0,
+    // the leftmost one. Negative values are shown as 0 (no glyph for '-').
+    // If the number doesn't fit, only the last digits are shown
+    unsigned int setValue(int value);
+    int getValue() const { return _value; }
+
+    int getSlotCount() const { return _slots; }
+    // 0-9 or BLANK
+    int getDigit(int slot) const { return _digits[slot]; }
+
+protected:
+    int _slots;
+    int _value;
+    signed char _digits[MAX_SLOTS];
+};
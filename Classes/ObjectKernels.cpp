@@ -0,0 +1,265 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ObjectKernels.h"
+
+#include <string.h>
+
+#if !defined(PARKOUR_NO_SIMD)
+  #if defined(__AVX__)
+    #define PARKOUR_KERNELS_AVX 1
+    #include <immintrin.h>
+  #elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define PARKOUR_KERNELS_SSE2 1
+    #include <emmintrin.h>
+  #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define PARKOUR_KERNELS_NEON 1
+    #include <arm_neon.h>
+  #endif
+#endif
+
+#if defined(PARKOUR_KERNELS_AVX) || defined(PARKOUR_KERNELS_SSE2)
+// 4 bits of a movemask to 4 mask bytes
+static const unsigned char MASK_BYTES[16][4] =
+{
+    {0, 0, 0, 0},
+    {1, 0, 0, 0},
+    {0, 1, 0, 0},
+    {1, 1, 0, 0},
+    {0, 0, 1, 0},
+    {1, 0, 1, 0},
+    {0, 1, 1, 0},
+    {1, 1, 1, 0},
+    {0, 0, 0, 1},
+    {1, 0, 0, 1},
+    {0, 1, 0, 1},
+    {1, 1, 0, 1},
+    {0, 0, 1, 1},
+    {1, 0, 1, 1},
+    {0, 1, 1, 1},
+    {1, 1, 1, 1},
+};
+static const int BITS_SET[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+#endif
+
+//
+// Scalar
+//
+void scrollObjectsScalar(float* x, int count, float dx)
+{
+    for (int i=0; i<count; i++)
+        x[i] -= dx;
+}
+
+int intersectObjectsScalar(const float* x, const float* y, const float* width, const float* height, int count,
+                           float rectX, float rectY, float rectWidth, float rectHeight,
+                           unsigned char* mask)
+{
+    const float rectMaxX = rectX + rectWidth;
+    const float rectMaxY = rectY + rectHeight;
+
+    int hits = 0;
+    for (int i=0; i<count; i++)
+    {
+        bool hit = !(rectMaxX < x[i] ||
+                     x[i] + width[i] < rectX ||
+                     rectMaxY < y[i] ||
+                     y[i] + height[i] < rectY);
+        mask[i] = hit;
+        hits += hit;
+    }
+    return hits;
+}
+
+//
+// SIMD
+//
+#if defined(PARKOUR_KERNELS_AVX)
+
+const char* getObjectKernelsName()
+{
+    return "avx";
+}
+
+void scrollObjects(float* x, int count, float dx)
+{
+    const __m256 vdx = _mm256_set1_ps(dx);
+    int i = 0;
+    for (; i+8<=count; i+=8)
+        _mm256_storeu_ps(x+i, _mm256_sub_ps(_mm256_loadu_ps(x+i), vdx));
+
+    scrollObjectsScalar(x+i, count-i, dx);
+}
+
+int intersectObjects(const float* x, const float* y, const float* width, const float* height, int count,
+                     float rectX, float rectY, float rectWidth, float rectHeight,
+                     unsigned char* mask)
+{
+    const __m256 minX = _mm256_set1_ps(rectX);
+    const __m256 minY = _mm256_set1_ps(rectY);
+    const __m256 maxX = _mm256_set1_ps(rectX + rectWidth);
+    const __m256 maxY = _mm256_set1_ps(rectY + rectHeight);
+
+    int hits = 0;
+    int i = 0;
+    for (; i+8<=count; i+=8)
+    {
+        __m256 ox = _mm256_loadu_ps(x+i);
+        __m256 oy = _mm256_loadu_ps(y+i);
+        __m256 oMaxX = _mm256_add_ps(ox, _mm256_loadu_ps(width+i));
+        __m256 oMaxY = _mm256_add_ps(oy, _mm256_loadu_ps(height+i));
+
+        // separated on any axis?
+        __m256 separated = _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(maxX, ox, _CMP_LT_OQ),
+                                                     _mm256_cmp_ps(oMaxX, minX, _CMP_LT_OQ)),
+                                        _mm256_or_ps(_mm256_cmp_ps(maxY, oy, _CMP_LT_OQ),
+                                                     _mm256_cmp_ps(oMaxY, minY, _CMP_LT_OQ)));
+        int bits = ~_mm256_movemask_ps(separated) & 0xff;
+        memcpy(mask+i, MASK_BYTES[bits & 0xf], 4);
+        memcpy(mask+i+4, MASK_BYTES[bits >> 4], 4);
+        hits += BITS_SET[bits & 0xf] + BITS_SET[bits >> 4];
+    }
+
+    return hits + intersectObjectsScalar(x+i, y+i, width+i, height+i, count-i,
+                                         rectX, rectY, rectWidth, rectHeight, mask+i);
+}
+
+#elif defined(PARKOUR_KERNELS_SSE2)
+
+const char* getObjectKernelsName()
+{
+    return "sse2";
+}
+
+void scrollObjects(float* x, int count, float dx)
+{
+    const __m128 vdx = _mm_set1_ps(dx);
+    int i = 0;
+    for (; i+4<=count; i+=4)
+        _mm_storeu_ps(x+i, _mm_sub_ps(_mm_loadu_ps(x+i), vdx));
+
+    scrollObjectsScalar(x+i, count-i, dx);
+}
+
+int intersectObjects(const float* x, const float* y, const float* width, const float* height, int count,
+                     float rectX, float rectY, float rectWidth, float rectHeight,
+                     unsigned char* mask)
+{
+    const __m128 minX = _mm_set1_ps(rectX);
+    const __m128 minY = _mm_set1_ps(rectY);
+    const __m128 maxX = _mm_set1_ps(rectX + rectWidth);
+    const __m128 maxY = _mm_set1_ps(rectY + rectHeight);
+
+    int hits = 0;
+    int i = 0;
+    for (; i+4<=count; i+=4)
+    {
+        __m128 ox = _mm_loadu_ps(x+i);
+        __m128 oy = _mm_loadu_ps(y+i);
+        __m128 oMaxX = _mm_add_ps(ox, _mm_loadu_ps(width+i));
+        __m128 oMaxY = _mm_add_ps(oy, _mm_loadu_ps(height+i));
+
+        // separated on any axis?
+        __m128 separated = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(maxX, ox), _mm_cmplt_ps(oMaxX, minX)),
+                                     _mm_or_ps(_mm_cmplt_ps(maxY, oy), _mm_cmplt_ps(oMaxY, minY)));
+        int bits = ~_mm_movemask_ps(separated) & 0xf;
+        memcpy(mask+i, MASK_BYTES[bits], 4);
+        hits += BITS_SET[bits];
+    }
+
+    return hits + intersectObjectsScalar(x+i, y+i, width+i, height+i, count-i,
+                                         rectX, rectY, rectWidth, rectHeight, mask+i);
+}
+
+#elif defined(PARKOUR_KERNELS_NEON)
+
+const char* getObjectKernelsName()
+{
+    return "neon";
+}
+
+void scrollObjects(float* x, int count, float dx)
+{
+    const float32x4_t vdx = vdupq_n_f32(dx);
+    int i = 0;
+    for (; i+4<=count; i+=4)
+        vst1q_f32(x+i, vsubq_f32(vld1q_f32(x+i), vdx));
+
+    scrollObjectsScalar(x+i, count-i, dx);
+}
+
+int intersectObjects(const float* x, const float* y, const float* width, const float* height, int count,
+                     float rectX, float rectY, float rectWidth, float rectHeight,
+                     unsigned char* mask)
+{
+    const float32x4_t minX = vdupq_n_f32(rectX);
+    const float32x4_t minY = vdupq_n_f32(rectY);
+    const float32x4_t maxX = vdupq_n_f32(rectX + rectWidth);
+    const float32x4_t maxY = vdupq_n_f32(rectY + rectHeight);
+
+    int hits = 0;
+    int i = 0;
+    for (; i+4<=count; i+=4)
+    {
+        float32x4_t ox = vld1q_f32(x+i);
+        float32x4_t oy = vld1q_f32(y+i);
+        float32x4_t oMaxX = vaddq_f32(ox, vld1q_f32(width+i));
+        float32x4_t oMaxY = vaddq_f32(oy, vld1q_f32(height+i));
+
+        // separated on any axis?
+        uint32x4_t separated = vorrq_u32(vorrq_u32(vcltq_f32(maxX, ox), vcltq_f32(oMaxX, minX)),
+                                         vorrq_u32(vcltq_f32(maxY, oy), vcltq_f32(oMaxY, minY)));
+        // 0xffffffff lanes to 1 byte per lane
+        uint16x4_t hits16 = vmovn_u32(vmvnq_u32(separated));
+        uint8x8_t hits8 = vand_u8(vmovn_u16(vcombine_u16(hits16, hits16)), vdup_n_u8(1));
+        uint8_t bytes[8];
+        vst1_u8(bytes, hits8);
+        memcpy(mask+i, bytes, 4);
+        hits += bytes[0] + bytes[1] + bytes[2] + bytes[3];
+    }
+
+    return hits + intersectObjectsScalar(x+i, y+i, width+i, height+i, count-i,
+                                         rectX, rectY, rectWidth, rectHeight, mask+i);
+}
+
+#else
+
+const char* getObjectKernelsName()
+{
+    return "scalar";
+}
+
+void scrollObjects(float* x, int count, float dx)
+{
+    scrollObjectsScalar(x, count, dx);
+}
+
+int intersectObjects(const float* x, const float* y, const float* width, const float* height, int count,
+                     float rectX, float rectY, float rectWidth, float rectHeight,
+                     unsigned char* mask)
+{
+    return intersectObjectsScalar(x, y, width, height, count, rectX, rectY, rectWidth, rectHeight, mask);
+}
+
+#endif
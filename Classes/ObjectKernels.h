@@ -0,0 +1,50 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+// Batched kernels over the ObjectStore arrays.
+// The SIMD flavor is selected at build time: AVX (8 objects per instruction),
+// SSE2 or NEON (4 objects per instruction). Defining PARKOUR_NO_SIMD
+// forces the scalar version.
+// All the flavors give exactly the same results.
+
+// name of the flavor selected at build time
+const char* getObjectKernelsName();
+
+// x[i] -= dx
+void scrollObjects(float* x, int count, float dx);
+
+// mask[i] = 1 if object 'i' intersects the rect, 0 otherwise.
+// Same semantics as World::Rect::intersects().
+// Returns the number of intersections
+int intersectObjects(const float* x, const float* y, const float* width, const float* height, int count,
+                     float rectX, float rectY, float rectWidth, float rectHeight,
+                     unsigned char* mask);
+
+// scalar versions. Always available, useful to compare against
+void scrollObjectsScalar(float* x, int count, float dx);
+int intersectObjectsScalar(const float* x, const float* y, const float* width, const float* height, int count,
+                           float rectX, float rectY, float rectWidth, float rectHeight,
+                           unsigned char* mask);
@@ -0,0 +1,399 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ObjectRenderer.h"
+
+#include <string.h>
+#include <algorithm>
+
+using namespace cocos2d;
+
+static const char* PROGRAM_KEY = "parkour_object_quads";
+
+// the vertex is the X of its object plus the corner of the frame
+static const char* VERTEX_SHADER = R"(
+attribute float a_x;
+attribute vec4 a_quad;
+
+#ifdef GL_ES
+varying mediump vec2 v_texCoord;
+#else
+varying vec2 v_texCoord;
+#endif
+
+void main()
+{
+    gl_Position = CC_MVPMatrix * vec4(a_x + a_quad.x, a_quad.y, 0.0, 1.0);
+    v_texCoord = a_quad.zw;
+}
+)";
+
+static const char* FRAGMENT_SHADER = R"(
+#ifdef GL_ES
+precision lowp float;
+#endif
+
+varying vec2 v_texCoord;
+
+void main()
+{
+    gl_FragColor = texture2D(CC_Texture0, v_texCoord);
+}
+)";
+
+static GLProgram* getProgram()
+{
+    auto cache = GLProgramCache::getInstance();
+    auto program = cache->getGLProgram(PROGRAM_KEY);
+    if (!program)
+    {
+        program = GLProgram::createWithByteArrays(VERTEX_SHADER, FRAGMENT_SHADER);
+        cache->addGLProgram(program, PROGRAM_KEY);
+    }
+    return program;
+}
+
+ObjectRenderer* ObjectRenderer::create(Texture2D* texture, int capacity)
+{
+    auto node = new (std::nothrow) ObjectRenderer();
+    if (node && node->init(texture, capacity))
+    {
+        node->autorelease();
+        return node;
+    }
+    CC_SAFE_DELETE(node);
+    return nullptr;
+}
+
+ObjectRenderer::ObjectRenderer()
+: _texture(nullptr)
+, _quadsDirty(0)
+, _capacity(0)
+, _bufferCapacity(0)
+, _growCount(0)
+, _indexBuffer(0)
+, _currentBuffer(0)
+, _xAttrib(-1)
+, _quadAttrib(-1)
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+, _rendererRecreatedListener(nullptr)
+#endif
+{
+    _xBuffers[0] = _xBuffers[1] = 0;
+    _quadBuffers[0] = _quadBuffers[1] = 0;
+}
+
+ObjectRenderer::~ObjectRenderer()
+{
+    if (_bufferCapacity)
+    {
+        glDeleteBuffers(2, _xBuffers);
+        glDeleteBuffers(2, _quadBuffers);
+        glDeleteBuffers(1, &_indexBuffer);
+    }
+    CC_SAFE_RELEASE(_texture);
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    if (_rendererRecreatedListener)
+        _eventDispatcher->removeEventListener(_rendererRecreatedListener);
+#endif
+}
+
+bool ObjectRenderer::init(Texture2D* texture, int capacity)
+{
+    if (!Node::init())
+        return false;
+
+    _texture = texture;
+    CC_SAFE_RETAIN(_texture);
+    _blendFunc = _texture->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
+
+    setGLProgram(getProgram());
+    _xAttrib = getGLProgram()->getAttribLocation("a_x");
+    _quadAttrib = getGLProgram()->getAttribLocation("a_quad");
+
+    reserve(capacity);
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // the GL objects are gone when the context is lost
+    _rendererRecreatedListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom* event){
+        auto program = getGLProgram();
+        program->reset();
+        program->initWithByteArrays(VERTEX_SHADER, FRAGMENT_SHADER);
+        program->link();
+        program->updateUniforms();
+        _xAttrib = program->getAttribLocation("a_x");
+        _quadAttrib = program->getAttribLocation("a_quad");
+        _bufferCapacity = 0;
+    });
+    _eventDispatcher->addEventListenerWithFixedPriority(_rendererRecreatedListener, -1);
+#endif
+
+    return true;
+}
+
+int ObjectRenderer::addFrame(SpriteFrame* spriteFrame)
+{
+    CCASSERT(spriteFrame->getTexture() == _texture, "all the frames must be in the same texture");
+
+    // same placement as a Sprite with (0,0) as anchor point
+    auto rect = spriteFrame->getRect();
+    auto size = spriteFrame->getOriginalSize();
+    auto offset = spriteFrame->getOffset();
+    float left = offset.x + (size.width - rect.size.width) / 2;
+    float bottom = offset.y + (size.height - rect.size.height) / 2;
+    float right = left + rect.size.width;
+    float top = bottom + rect.size.height;
+
+    Frame frame = {
+        {left, right, left, right},
+        {bottom, bottom, top, top},
+    };
+
+    // same texture coordinates as Sprite::setTextureCoords()
+    auto pixels = spriteFrame->getRectInPixels();
+    float width = _texture->getPixelsWide();
+    float height = _texture->getPixelsHigh();
+    if (spriteFrame->isRotated())
+    {
+        float u0 = pixels.origin.x / width;
+        float u1 = (pixels.origin.x + pixels.size.height) / width;
+        float v0 = pixels.origin.y / height;
+        float v1 = (pixels.origin.y + pixels.size.width) / height;
+        float u[4] = {u0, u0, u1, u1};
+        float v[4] = {v0, v1, v0, v1};
+        std::copy(u, u+4, frame.u);
+        std::copy(v, v+4, frame.v);
+    }
+    else
+    {
+        float u0 = pixels.origin.x / width;
+        float u1 = (pixels.origin.x + pixels.size.width) / width;
+        float v0 = (pixels.origin.y + pixels.size.height) / height;
+        float v1 = pixels.origin.y / height;
+        float u[4] = {u0, u1, u0, u1};
+        float v[4] = {v0, v0, v1, v1};
+        std::copy(u, u+4, frame.u);
+        std::copy(v, v+4, frame.v);
+    }
+
+    _frames.push_back(frame);
+    return (int)_frames.size() - 1;
+}
+
+void ObjectRenderer::addQuad(int frame, float x, float y)
+{
+    if (getQuadCount() == _capacity)
+    {
+        reserve(_capacity * 2);
+        _growCount++;
+    }
+
+    _quadFrame.push_back(frame);
+    _quadY.push_back(y);
+    _x.insert(_x.end(), 4, x);
+    _quads.resize(_quads.size() + 4);
+    writeQuad(getQuadCount() - 1);
+}
+
+void ObjectRenderer::setQuadFrame(int index, int frame)
+{
+    if (_quadFrame[index] != frame)
+    {
+        _quadFrame[index] = frame;
+        writeQuad(index);
+    }
+}
+
+void ObjectRenderer::hideQuad(int index)
+{
+    setQuadFrame(index, -1);
+}
+
+void ObjectRenderer::removeQuads(int count)
+{
+    _quadFrame.erase(_quadFrame.begin(), _quadFrame.begin() + count);
+    _quadY.erase(_quadY.begin(), _quadY.begin() + count);
+    _x.erase(_x.begin(), _x.begin() + count * 4);
+    _quads.erase(_quads.begin(), _quads.begin() + count * 4);
+    _quadsDirty = 2;
+}
+
+void ObjectRenderer::clear()
+{
+    _quadFrame.clear();
+    _quadY.clear();
+    _x.clear();
+    _quads.clear();
+    _quadsDirty = 2;
+}
+
+void ObjectRenderer::setX(const float* x, int count, float offset)
+{
+    CCASSERT(count == getQuadCount(), "one X per quad");
+
+    GLfloat* vertexX = _x.data();
+    for (int i=0; i<count; i++)
+    {
+        float quadX = x[i] + offset;
+        vertexX[0] = quadX;
+        vertexX[1] = quadX;
+        vertexX[2] = quadX;
+        vertexX[3] = quadX;
+        vertexX += 4;
+    }
+}
+
+void ObjectRenderer::writeQuad(int index)
+{
+    QuadVertex* vertices = &_quads[index * 4];
+    int frame = _quadFrame[index];
+    if (frame < 0)
+    {
+        // degenerated: nothing is rasterized
+        memset(vertices, 0, sizeof(QuadVertex) * 4);
+    }
+    else
+    {
+        auto& corners = _frames[frame];
+        float y = _quadY[index];
+        for (int i=0; i<4; i++)
+        {
+            vertices[i].dx = corners.x[i];
+            vertices[i].y = y + corners.y[i];
+            vertices[i].u = corners.u[i];
+            vertices[i].v = corners.v[i];
+        }
+    }
+    _quadsDirty = 2;
+}
+
+void ObjectRenderer::reserve(int capacity)
+{
+    CCASSERT(capacity * 4 <= 65536, "indices are 16 bits");
+
+    _capacity = capacity;
+    _quadFrame.reserve(capacity);
+    _quadY.reserve(capacity);
+    _x.reserve(capacity * 4);
+    _quads.reserve(capacity * 4);
+}
+
+void ObjectRenderer::setupBuffers()
+{
+    if (_bufferCapacity)
+    {
+        glDeleteBuffers(2, _xBuffers);
+        glDeleteBuffers(2, _quadBuffers);
+        glDeleteBuffers(1, &_indexBuffer);
+    }
+    _bufferCapacity = _capacity;
+
+    glGenBuffers(2, _xBuffers);
+    glGenBuffers(2, _quadBuffers);
+    glGenBuffers(1, &_indexBuffer);
+    for (int i=0; i<2; i++)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, _xBuffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 4 * _bufferCapacity, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, _quadBuffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(QuadVertex) * 4 * _bufferCapacity, nullptr, GL_DYNAMIC_DRAW);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // bottom left, bottom right, top left / top left, bottom right, top right
+    std::vector<GLushort> indices(_bufferCapacity * 6);
+    for (int i=0; i<_bufferCapacity; i++)
+    {
+        GLushort vertex = (GLushort)(i * 4);
+        GLushort* quad = &indices[i * 6];
+        quad[0] = vertex;
+        quad[1] = vertex + 1;
+        quad[2] = vertex + 2;
+        quad[3] = vertex + 2;
+        quad[4] = vertex + 1;
+        quad[5] = vertex + 3;
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * indices.size(), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    _quadsDirty = 2;
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void ObjectRenderer::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
+{
+    if (_quadY.empty())
+        return;
+
+    _command.init(_globalZOrder, transform, flags);
+    _command.func = CC_CALLBACK_0(ObjectRenderer::onDraw, this, transform, flags);
+    renderer->addCommand(&_command);
+}
+
+void ObjectRenderer::onDraw(const Mat4& transform, uint32_t flags)
+{
+    // created here, the first time or when the quads didn't fit
+    if (_bufferCapacity < _capacity)
+        setupBuffers();
+
+    int count = getQuadCount();
+
+    auto program = getGLProgram();
+    program->use();
+    program->setUniformsForBuiltins(transform);
+    GL::bindTexture2D(_texture->getName());
+    GL::blendFunc(_blendFunc.src, _blendFunc.dst);
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+        GL::bindVAO(0);
+    GL::enableVertexAttribs((1 << _xAttrib) | (1 << _quadAttrib));
+
+    // X changes every frame
+    glBindBuffer(GL_ARRAY_BUFFER, _xBuffers[_currentBuffer]);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(GLfloat) * 4 * count, _x.data());
+    glVertexAttribPointer(_xAttrib, 1, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    // the rest only when objects are added, removed or animated.
+    // Each buffer has to be updated once
+    glBindBuffer(GL_ARRAY_BUFFER, _quadBuffers[_currentBuffer]);
+    if (_quadsDirty > 0)
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(QuadVertex) * 4 * count, _quads.data());
+        _quadsDirty--;
+    }
+    glVertexAttribPointer(_quadAttrib, 4, GL_FLOAT, GL_FALSE, sizeof(QuadVertex), nullptr);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+    glDrawElements(GL_TRIANGLES, count * 6, GL_UNSIGNED_SHORT, nullptr);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    _currentBuffer = 1 - _currentBuffer;
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, count * 4);
+    CHECK_GL_ERROR_DEBUG();
+}
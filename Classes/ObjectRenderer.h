@@ -0,0 +1,130 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "cocos2d.h"
+
+// Renders the scrolling world objects (coins, boxes and anvils) as a
+// stream of quads, with one draw call and without Sprites.
+//
+// There is one quad per world object, with the same index as
+// World::getObjects(), so spawning and removing objects is just like
+// in the ObjectStore. Every frame only the X of the objects changes,
+// so the vertices are split in two streams:
+// - X: the position of the object. Written every frame with setX()
+//   into one of two buffers, alternated each frame so the upload
+//   doesn't wait for the GPU to finish with the previous one
+// - quad: corner offset, Y and texture coordinates. Uploaded only
+//   when objects are added, removed, hidden or change frame
+// All the frames must be in the same texture.
+// NumericLabel uses it for its digits too.
+class ObjectRenderer : public cocos2d::Node
+{
+public:
+    static ObjectRenderer* create(cocos2d::Texture2D* texture, int capacity);
+    bool init(cocos2d::Texture2D* texture, int capacity);
+
+    // frames are referenced by the returned id
+    int addFrame(cocos2d::SpriteFrame* frame);
+
+    // appends a quad with the bottom left corner at (x, y).
+    // Frame -1 is a hidden quad
+    void addQuad(int frame, float x, float y);
+    void setQuadFrame(int index, int frame);
+    // hidden quads are not drawn. Indices don't change
+    void hideQuad(int index);
+    // removes the first 'count' quads. The rest are shifted
+    void removeQuads(int count);
+    void clear();
+    int getQuadCount() const { return (int)_quadY.size(); }
+
+    // X of every quad: x[i] + offset
+    void setX(const float* x, int count, float offset);
+
+    // the quads are allocated in advance. It grows only if more are needed
+    int getCapacity() const { return _capacity; }
+    int getGrowCount() const { return _growCount; }
+
+    virtual void draw(cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t flags) override;
+
+protected:
+    ObjectRenderer();
+    virtual ~ObjectRenderer();
+
+    // corners of a frame, in the order of the vertices:
+    // bottom left, bottom right, top left, top right
+    struct Frame
+    {
+        float x[4];                     // offset from the quad position
+        float y[4];
+        float u[4];
+        float v[4];
+    };
+
+    // one vertex of the quad stream
+    struct QuadVertex
+    {
+        GLfloat dx;
+        GLfloat y;
+        GLfloat u;
+        GLfloat v;
+    };
+
+    void onDraw(const cocos2d::Mat4& transform, uint32_t flags);
+    void writeQuad(int index);
+    void reserve(int capacity);
+    void setupBuffers();
+
+    cocos2d::Texture2D* _texture;
+    cocos2d::BlendFunc _blendFunc;
+    cocos2d::CustomCommand _command;
+    std::vector<Frame> _frames;
+
+    // per quad
+    std::vector<int> _quadFrame;        // -1 when hidden
+    std::vector<float> _quadY;
+
+    // per vertex, 4 per quad
+    std::vector<GLfloat> _x;
+    std::vector<QuadVertex> _quads;
+    int _quadsDirty;                    // buffers that still have to be updated with _quads
+
+    int _capacity;
+    int _bufferCapacity;                // of the GL buffers. 0 until they are created
+    int _growCount;
+
+    GLuint _xBuffers[2];
+    GLuint _quadBuffers[2];
+    GLuint _indexBuffer;
+    int _currentBuffer;
+    GLint _xAttrib;
+    GLint _quadAttrib;
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    cocos2d::EventListenerCustom* _rendererRecreatedListener;
+#endif
+};
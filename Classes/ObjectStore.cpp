@@ -0,0 +1,84 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ObjectStore.h"
+#include "ObjectKernels.h"
+
+void ObjectStore::push(int objectType, float objectX, float objectY, float objectWidth, float objectHeight, int objectColumn, int objectRow, int objectMap)
+{
+    x.push_back(objectX);
+    y.push_back(objectY);
+    width.push_back(objectWidth);
+    height.push_back(objectHeight);
+    type.push_back((unsigned char)objectType);
+    alive.push_back(1);
+    column.push_back((short)objectColumn);
+    row.push_back((short)objectRow);
+    map.push_back((unsigned char)objectMap);
+    aliveCount++;
+}
+
+void ObjectStore::kill(int index)
+{
+    if (alive[index])
+    {
+        alive[index] = 0;
+        aliveCount--;
+    }
+}
+
+void ObjectStore::eraseFront(int count)
+{
+    for (int i=0; i<count; i++)
+        aliveCount -= alive[i];
+
+    x.erase(x.begin(), x.begin() + count);
+    y.erase(y.begin(), y.begin() + count);
+    width.erase(width.begin(), width.begin() + count);
+    height.erase(height.begin(), height.begin() + count);
+    type.erase(type.begin(), type.begin() + count);
+    alive.erase(alive.begin(), alive.begin() + count);
+    column.erase(column.begin(), column.begin() + count);
+    row.erase(row.begin(), row.begin() + count);
+    map.erase(map.begin(), map.begin() + count);
+}
+
+void ObjectStore::clear()
+{
+    x.clear();
+    y.clear();
+    width.clear();
+    height.clear();
+    type.clear();
+    alive.clear();
+    column.clear();
+    row.clear();
+    map.clear();
+    aliveCount = 0;
+}
+
+void ObjectStore::scroll(float dx)
+{
+    scrollObjects(x.data(), size(), dx);
+}
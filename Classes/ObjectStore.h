@@ -0,0 +1,60 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+// The world objects stored as a structure of arrays.
+// Objects are always sorted by X. Objects that were collected are not
+// removed, they are flagged as not alive, so the indices are stable
+// until the objects scroll out of the screen and are removed from the front.
+struct ObjectStore
+{
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> width;
+    std::vector<float> height;
+    std::vector<unsigned char> type;    // World::ObjectType
+    std::vector<unsigned char> alive;
+    std::vector<short> column;          // map cell that spawned the object
+    std::vector<short> row;
+    std::vector<unsigned char> map;     // map that spawned the object. See World::getMapCount()
+    int aliveCount;
+
+    ObjectStore() : aliveCount(0) {}
+
+    int size() const { return (int)x.size(); }
+    bool empty() const { return x.empty(); }
+
+    // objects must be pushed in X order
+    void push(int objectType, float objectX, float objectY, float objectWidth, float objectHeight, int objectColumn, int objectRow, int objectMap = 0);
+    void kill(int index);
+    // removes the first 'count' objects
+    void eraseFront(int count);
+    void clear();
+
+    // moves all the objects 'dx' pixels to the left
+    void scroll(float dx);
+};
@@ -0,0 +1,222 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ParallaxLayers.h"
+
+#include <math.h>
+
+using namespace cocos2d;
+
+static const char* PROGRAM_KEY = "parkour_parallax_layers";
+
+// u_offset: scrolled distance, in periods (the width of both tiles)
+// wrapped to [0,1) on the CPU. The X of the texture coordinate is in
+// periods too, so the values stay small
+static const char* VERTEX_SHADER = R"(
+attribute vec4 a_position;
+attribute vec2 a_texCoord;
+
+uniform float u_offset;
+
+varying vec2 v_texCoord;
+
+void main()
+{
+    gl_Position = CC_MVPMatrix * a_position;
+    v_texCoord = vec2(a_texCoord.x + u_offset, a_texCoord.y);
+}
+)";
+
+// u_split: where the second tile starts, as a fraction of the period.
+// The wrapped X is in [0,1): mediump is precise enough for any tile width
+static const char* FRAGMENT_SHADER = R"(
+#ifdef GL_ES
+precision mediump float;
+#endif
+
+uniform float u_split;
+
+varying vec2 v_texCoord;
+
+void main()
+{
+    float x = fract(v_texCoord.x);
+    if (x < u_split)
+        gl_FragColor = texture2D(CC_Texture0, vec2(x / u_split, v_texCoord.y));
+    else
+        gl_FragColor = texture2D(CC_Texture1, vec2((x - u_split) / (1.0 - u_split), v_texCoord.y));
+}
+)";
+
+static GLProgram* getProgram()
+{
+    auto cache = GLProgramCache::getInstance();
+    auto program = cache->getGLProgram(PROGRAM_KEY);
+    if (!program)
+    {
+        program = GLProgram::createWithByteArrays(VERTEX_SHADER, FRAGMENT_SHADER);
+        cache->addGLProgram(program, PROGRAM_KEY);
+    }
+    return program;
+}
+
+ParallaxLayers* ParallaxLayers::create()
+{
+    auto node = new (std::nothrow) ParallaxLayers();
+    if (node && node->init())
+    {
+        node->autorelease();
+        return node;
+    }
+    CC_SAFE_DELETE(node);
+    return nullptr;
+}
+
+ParallaxLayers::ParallaxLayers()
+: _offsetUniform(-1)
+, _splitUniform(-1)
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+, _rendererRecreatedListener(nullptr)
+#endif
+{
+}
+
+ParallaxLayers::~ParallaxLayers()
+{
+    for (auto& layer : _layers)
+    {
+        CC_SAFE_RELEASE(layer.tiles[0]);
+        CC_SAFE_RELEASE(layer.tiles[1]);
+    }
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    if (_rendererRecreatedListener)
+        _eventDispatcher->removeEventListener(_rendererRecreatedListener);
+#endif
+}
+
+bool ParallaxLayers::init()
+{
+    if (!Node::init())
+        return false;
+
+    // the quads cover the whole screen
+    setContentSize(Director::getInstance()->getVisibleSize());
+
+    setGLProgram(getProgram());
+    _offsetUniform = getGLProgram()->getUniformLocation("u_offset");
+    _splitUniform = getGLProgram()->getUniformLocation("u_split");
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // the program is gone when the context is lost
+    _rendererRecreatedListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom* event){
+        auto program = getGLProgram();
+        program->reset();
+        program->initWithByteArrays(VERTEX_SHADER, FRAGMENT_SHADER);
+        program->link();
+        program->updateUniforms();
+        _offsetUniform = program->getUniformLocation("u_offset");
+        _splitUniform = program->getUniformLocation("u_split");
+    });
+    _eventDispatcher->addEventListenerWithFixedPriority(_rendererRecreatedListener, -1);
+#endif
+
+    return true;
+}
+
+void ParallaxLayers::addLayer(Texture2D* tile0, Texture2D* tile1, float speed)
+{
+    // one tile is repeated with itself
+    if (!tile1)
+        tile1 = tile0;
+
+    Layer layer;
+    layer.tiles[0] = tile0;
+    layer.tiles[1] = tile1;
+    tile0->retain();
+    tile1->retain();
+    layer.speed = speed;
+    float tileWidth = tile0->getContentSize().width;
+    layer.period = tileWidth + tile1->getContentSize().width;
+    layer.split = tileWidth / layer.period;
+    layer.offset = 0;
+
+    // bottom left, bottom right, top left, top right
+    float width = _contentSize.width;
+    float height = tile0->getContentSize().height;
+    float u = width / layer.period;
+    layer.vertices[0] = {Vec2(0, 0), Tex2F(0, 1)};
+    layer.vertices[1] = {Vec2(width, 0), Tex2F(u, 1)};
+    layer.vertices[2] = {Vec2(0, height), Tex2F(0, 0)};
+    layer.vertices[3] = {Vec2(width, height), Tex2F(u, 0)};
+
+    _layers.push_back(layer);
+    _commands.resize(_layers.size());
+}
+
+void ParallaxLayers::setScrollDistance(double distance)
+{
+    // wrapped in double precision: the distance grows for the whole run
+    for (auto& layer : _layers)
+        layer.offset = (float)(fmod(distance * layer.speed, (double)layer.period) / layer.period);
+}
+
+void ParallaxLayers::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
+{
+    for (int i=0; i<(int)_layers.size(); i++)
+    {
+        _commands[i].init(_globalZOrder, transform, flags);
+        _commands[i].func = CC_CALLBACK_0(ParallaxLayers::onDraw, this, i, transform, flags);
+        renderer->addCommand(&_commands[i]);
+    }
+}
+
+void ParallaxLayers::onDraw(int index, const Mat4& transform, uint32_t flags)
+{
+    auto& layer = _layers[index];
+
+    auto program = getGLProgram();
+    program->use();
+    program->setUniformsForBuiltins(transform);
+    program->setUniformLocationWith1f(_offsetUniform, layer.offset);
+    program->setUniformLocationWith1f(_splitUniform, layer.split);
+
+    GL::bindTexture2DN(0, layer.tiles[0]->getName());
+    GL::bindTexture2DN(1, layer.tiles[1]->getName());
+    if (layer.tiles[0]->hasPremultipliedAlpha())
+        GL::blendFunc(BlendFunc::ALPHA_PREMULTIPLIED.src, BlendFunc::ALPHA_PREMULTIPLIED.dst);
+    else
+        GL::blendFunc(BlendFunc::ALPHA_NON_PREMULTIPLIED.src, BlendFunc::ALPHA_NON_PREMULTIPLIED.dst);
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+        GL::bindVAO(0);
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POSITION | GL::VERTEX_ATTRIB_FLAG_TEX_COORD);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_T2F), &layer.vertices[0].vertices);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORDS, 2, GL_FLOAT, GL_FALSE, sizeof(V2F_T2F), &layer.vertices[0].texCoords);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, 4);
+    CHECK_GL_ERROR_DEBUG();
+}
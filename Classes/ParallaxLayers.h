@@ -0,0 +1,79 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "cocos2d.h"
+
+// Endless horizontal scrolling of layers that move at different speeds.
+//
+// A layer is one or two images (tiles) placed one after the other and
+// repeated forever. Each layer is drawn as a single quad as wide as the
+// node, and the shader wraps the texture coordinates around the tiles,
+// so scrolling only changes a uniform: no node is moved nor re-sorted.
+// Layers are drawn in the order they were added.
+class ParallaxLayers : public cocos2d::Node
+{
+public:
+    static ParallaxLayers* create();
+    bool init();
+
+    // 'speed' is a factor of the scroll distance: 1 moves with the
+    // foreground, 0.1 ten times slower. 'tile1' can be nullptr.
+    // The tiles must have the same height
+    void addLayer(cocos2d::Texture2D* tile0, cocos2d::Texture2D* tile1, float speed);
+    int getLayerCount() const { return (int)_layers.size(); }
+
+    // pixels scrolled by the foreground since the beginning
+    void setScrollDistance(double distance);
+
+    virtual void draw(cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t flags) override;
+
+protected:
+    ParallaxLayers();
+    virtual ~ParallaxLayers();
+
+    struct Layer
+    {
+        cocos2d::Texture2D* tiles[2];
+        float speed;
+        float period;                   // width of all the tiles, in points
+        float split;                    // width of tiles[0] / period
+        float offset;                   // scrolled periods, wrapped to [0,1)
+        cocos2d::V2F_T2F vertices[4];   // x and y in points, u in periods and v
+    };
+
+    void onDraw(int layer, const cocos2d::Mat4& transform, uint32_t flags);
+
+    std::vector<Layer> _layers;
+    std::vector<cocos2d::CustomCommand> _commands;
+    GLint _offsetUniform;
+    GLint _splitUniform;
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    cocos2d::EventListenerCustom* _rendererRecreatedListener;
+#endif
+};
@@ -0,0 +1,135 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Profiler.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+static const char* SECTION_NAMES[Profiler::SECTIONS] = {
+    "frame",
+    "step",
+    "processEvents",
+    "updateScroll",
+    "updateActor",
+    "updateObjects",
+    "updateScore",
+    "checkCollisions",
+};
+
+Profiler* Profiler::getInstance()
+{
+    static thread_local Profiler instance;
+    return &instance;
+}
+
+const char* Profiler::getSectionName(Section section)
+{
+    return SECTION_NAMES[section];
+}
+
+Profiler::Profiler()
+{
+    clear();
+}
+
+void Profiler::addSample(Section section, float microseconds)
+{
+    _samples[section][_next[section]] = microseconds;
+    _next[section] = (_next[section] + 1) % SAMPLES;
+    if (_count[section] < SAMPLES)
+        _count[section]++;
+}
+
+Profiler::Stats Profiler::getStats(Section section) const
+{
+    Stats stats = {_count[section], 0, 0, 0, 0, 0};
+    if (stats.count == 0)
+        return stats;
+
+    // percentiles are taken from a sorted copy of the window
+    float sorted[SAMPLES];
+    std::copy(_samples[section], _samples[section] + stats.count, sorted);
+    std::sort(sorted, sorted + stats.count);
+
+    double total = 0;
+    for (int i=0; i<stats.count; i++)
+        total += sorted[i];
+
+    stats.mean = total / stats.count;
+    stats.p50 = sorted[(stats.count - 1) * 50 / 100];
+    stats.p95 = sorted[(stats.count - 1) * 95 / 100];
+    stats.p99 = sorted[(stats.count - 1) * 99 / 100];
+    stats.max = sorted[stats.count - 1];
+    return stats;
+}
+
+void Profiler::clear()
+{
+    for (int i=0; i<SECTIONS; i++)
+    {
+        _next[i] = 0;
+        _count[i] = 0;
+    }
+}
+
+bool Profiler::dumpCSV(const std::string& path) const
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+
+    fprintf(file, "section,count,mean_us,p50_us,p95_us,p99_us,max_us\n");
+    for (int i=0; i<SECTIONS; i++)
+    {
+        Stats stats = getStats((Section)i);
+        fprintf(file, "%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n", SECTION_NAMES[i],
+                stats.count, stats.mean, stats.p50, stats.p95, stats.p99, stats.max);
+    }
+    return fclose(file) == 0;
+}
+
+bool Profiler::dumpJSON(const std::string& path) const
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+
+    fprintf(file, "{\n  \"sections\": [\n");
+    for (int i=0; i<SECTIONS; i++)
+    {
+        Stats stats = getStats((Section)i);
+        fprintf(file, "    {\"name\": \"%s\", \"count\": %d, \"mean_us\": %.3f, \"p50_us\": %.3f, \"p95_us\": %.3f, \"p99_us\": %.3f, \"max_us\": %.3f,\n",
+                SECTION_NAMES[i], stats.count, stats.mean, stats.p50, stats.p95, stats.p99, stats.max);
+
+        // oldest sample first
+        fprintf(file, "     \"samples_us\": [");
+        int first = (_next[i] - _count[i] + SAMPLES) % SAMPLES;
+        for (int j=0; j<_count[i]; j++)
+            fprintf(file, "%s%.3f", j ? ", " : "", _samples[i][(first + j) % SAMPLES]);
+        fprintf(file, "]}%s\n", i < SECTIONS - 1 ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
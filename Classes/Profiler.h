@@ -0,0 +1,111 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <string>
+
+// Timers for the sections of the game loop.
+// Every section keeps its last SAMPLES durations, so the percentiles
+// are the ones of the last seconds of gameplay, not of the whole session.
+//
+// The timers are compiled in only when PARKOUR_ENABLE_PROFILER is defined
+// (cmake -DPARKOUR_PROFILER=ON). Otherwise PARKOUR_PROFILE() expands to nothing.
+class Profiler
+{
+public:
+    enum Section {
+        FRAME,              // GameNode::update
+        STEP,               // World::step
+        PROCESS_EVENTS,
+        UPDATE_SCROLL,
+        UPDATE_ACTOR,
+        UPDATE_OBJECTS,
+        UPDATE_SCORE,
+        CHECK_COLLISIONS,
+        SECTIONS
+    };
+
+    // in microseconds, of the samples in the window
+    struct Stats
+    {
+        int count;
+        float mean;
+        float p50;
+        float p95;
+        float p99;
+        float max;
+    };
+
+    static const int SAMPLES = 1024;
+
+    // one profiler per thread: worlds simulated in other threads don't mix
+    static Profiler* getInstance();
+    static const char* getSectionName(Section section);
+
+    void addSample(Section section, float microseconds);
+    Stats getStats(Section section) const;
+    void clear();
+
+    // one line per section with its stats
+    bool dumpCSV(const std::string& path) const;
+    // the stats plus the samples of every section
+    bool dumpJSON(const std::string& path) const;
+
+protected:
+    Profiler();
+
+    float _samples[SECTIONS][SAMPLES];  // ring buffers
+    int _next[SECTIONS];                // where the next sample goes
+    int _count[SECTIONS];               // samples in the ring buffer
+};
+
+// measures the lifetime of the scope
+class ProfileScope
+{
+public:
+    explicit ProfileScope(Profiler::Section section)
+    : _section(section)
+    , _start(std::chrono::steady_clock::now())
+    {}
+
+    ~ProfileScope()
+    {
+        std::chrono::duration<float, std::micro> elapsed = std::chrono::steady_clock::now() - _start;
+        Profiler::getInstance()->addSample(_section, elapsed.count());
+    }
+
+protected:
+    Profiler::Section _section;
+    std::chrono::steady_clock::time_point _start;
+};
+
+#ifdef PARKOUR_ENABLE_PROFILER
+#define PARKOUR_PROFILE_NAME2(line) _profileScope##line
+#define PARKOUR_PROFILE_NAME(line) PARKOUR_PROFILE_NAME2(line)
+#define PARKOUR_PROFILE(section) ProfileScope PARKOUR_PROFILE_NAME(__LINE__)(Profiler::section)
+#else
+#define PARKOUR_PROFILE(section)
+#endif
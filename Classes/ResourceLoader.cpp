@@ -0,0 +1,227 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ResourceLoader.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace cocos2d;
+
+// decoding is mostly inflate, two threads are enough for a handful of files
+static const int LOADER_THREADS = 2;
+// sprite frames created per step of update()
+static const size_t FRAMES_PER_STEP = 16;
+
+ResourceLoader* ResourceLoader::getInstance()
+{
+    // never destroyed: the textures it keeps must not be released
+    // after the GL context is gone
+    static ResourceLoader* instance = new ResourceLoader();
+    return instance;
+}
+
+ResourceLoader::ResourceLoader()
+: _finished(0)
+, _total(0)
+, _started(false)
+{
+}
+
+void ResourceLoader::addImage(const std::string& file)
+{
+    addItem(file, false);
+}
+
+void ResourceLoader::addSpriteFrames(const std::string& plist)
+{
+    addItem(plist, true);
+}
+
+void ResourceLoader::addItem(const std::string& file, bool sheet)
+{
+    CCASSERT(!_started, "ResourceLoader: files must be added before start()");
+
+    Item item;
+    item.file = file;
+    // FileUtils caches the full paths in a map that is not thread safe:
+    // the workers only get absolute paths, which skip the cache
+    item.path = FileUtils::getInstance()->fullPathForFilename(file);
+    item.sheet = sheet;
+    item.image = nullptr;
+    item.texture = nullptr;
+    item.nextFrame = 0;
+    _queued.push_back(item);
+}
+
+void ResourceLoader::start()
+{
+    if (_started)
+        return;
+    _started = true;
+    _total = (int)_queued.size();
+    if (_queued.empty())
+        return;
+
+    _pool.reset(new TaskPool(LOADER_THREADS));
+    for (auto& queued : _queued)
+    {
+        _pool->submit([this, queued]() mutable {
+            decodeItem(queued);
+            std::lock_guard<std::mutex> lock(_mutex);
+            _decoded.push_back(queued);
+        });
+    }
+    _queued.clear();
+}
+
+void ResourceLoader::decodeItem(Item& item)
+{
+    if (item.sheet && !parseSpriteFrames(item))
+        return;
+
+    auto image = new (std::nothrow) Image();
+    if (image && image->initWithImageFile(item.path))
+    {
+        item.image = image;
+    }
+    else
+    {
+        CCLOG("ResourceLoader: cannot decode %s", item.path.c_str());
+        CC_SAFE_RELEASE(image);
+    }
+}
+
+bool ResourceLoader::parseSpriteFrames(Item& item)
+{
+    // same as SpriteFrameCache::addSpriteFramesWithFile(), for the formats
+    // TexturePacker writes. The plist name is replaced by the image name
+    auto dict = FileUtils::getInstance()->getValueMapFromFile(item.path);
+    int format = -1;
+    std::string textureFile;
+    if (dict["metadata"].getType() == Value::Type::MAP)
+    {
+        auto& metadata = dict["metadata"].asValueMap();
+        format = metadata["format"].asInt();
+        textureFile = metadata["textureFileName"].asString();
+    }
+    if ((format != 1 && format != 2) || textureFile.empty() || dict["frames"].getType() != Value::Type::MAP)
+    {
+        CCLOG("ResourceLoader: unsupported sprite sheet %s", item.path.c_str());
+        return false;
+    }
+    item.path = item.path.substr(0, item.path.find_last_of("/") + 1) + textureFile;
+
+    auto& frames = dict["frames"].asValueMap();
+    item.frames.reserve(frames.size());
+    for (auto& entry : frames)
+    {
+        auto& frameDict = entry.second.asValueMap();
+        Frame frame;
+        frame.name = entry.first;
+        frame.rect = RectFromString(frameDict["frame"].asString());
+        frame.rotated = format == 2 && frameDict["rotated"].asBool();
+        frame.offset = PointFromString(frameDict["offset"].asString());
+        frame.originalSize = SizeFromString(frameDict["sourceSize"].asString());
+        item.frames.push_back(frame);
+    }
+    return true;
+}
+
+void ResourceLoader::update(float budget)
+{
+    if (!_started || isReady())
+        return;
+
+    typedef std::chrono::steady_clock Clock;
+    auto start = Clock::now();
+    do
+    {
+        if (_uploading.empty())
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _uploading.swap(_decoded);
+        }
+        if (_uploading.empty())
+            break;
+
+        auto& item = _uploading.front();
+        if (!uploadStep(item))
+        {
+            if (item.texture)
+                _loaded.insert(item.file);
+            _finished++;
+            _uploading.erase(_uploading.begin());
+        }
+    }
+    while (std::chrono::duration<float>(Clock::now() - start).count() < budget);
+
+    if (isReady())
+    {
+        // the threads are idle, no need to keep them
+        _pool.reset();
+        CCLOG("ResourceLoader: %d of %d files loaded", (int)_loaded.size(), _total);
+    }
+}
+
+bool ResourceLoader::uploadStep(Item& item)
+{
+    if (item.image)
+    {
+        item.texture = Director::getInstance()->getTextureCache()->addImage(item.image, item.path);
+        item.image->release();
+        item.image = nullptr;
+        if (item.texture)
+            _textures.pushBack(item.texture);
+        return item.texture && !item.frames.empty();
+    }
+    if (!item.texture)
+        return false;
+
+    auto frameCache = SpriteFrameCache::getInstance();
+    size_t end = std::min(item.nextFrame + FRAMES_PER_STEP, item.frames.size());
+    for (; item.nextFrame < end; item.nextFrame++)
+    {
+        auto& frame = item.frames[item.nextFrame];
+        auto spriteFrame = SpriteFrame::createWithTexture(item.texture, frame.rect, frame.rotated, frame.offset, frame.originalSize);
+        frameCache->addSpriteFrame(spriteFrame, frame.name);
+        _frames.pushBack(spriteFrame);
+    }
+    return item.nextFrame < item.frames.size();
+}
+
+bool ResourceLoader::isReady() const
+{
+    return _started && _finished == _total;
+}
+
+bool ResourceLoader::isLoaded(const std::string& file) const
+{
+    return _loaded.count(file) > 0;
+}
+
+float ResourceLoader::getProgress() const
+{
+    return _total > 0 ? (float)_finished / _total : (_started ? 1.0f : 0.0f);
+}
@@ -0,0 +1,111 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "cocos2d.h"
+#include "TaskPool.h"
+
+// Loads the images and sprite sheets of the game in the background,
+// while the main menu is shown.
+//
+// The PNGs are decoded and the plists parsed on worker threads. The
+// GL uploads and the creation of the sprite frames need the main
+// thread: update() does them a few at a time, so the menu keeps its
+// frame rate. The loaded textures and frames are kept alive, and end
+// up in the TextureCache and the SpriteFrameCache as if they had been
+// loaded with addImage() and addSpriteFramesWithFile().
+class ResourceLoader
+{
+public:
+    static ResourceLoader* getInstance();
+
+    // queue the files to load. Must be called before start()
+    void addImage(const std::string& file);
+    void addSpriteFrames(const std::string& plist);
+
+    // starts decoding on the worker threads. Does nothing if already started
+    void start();
+    // uploads the decoded resources until 'budget' seconds have passed,
+    // one at least. Main thread, once per frame
+    void update(float budget);
+
+    bool isStarted() const { return _started; }
+    bool isReady() const;
+    // the file was queued and is already in the caches
+    bool isLoaded(const std::string& file) const;
+    // loaded files / queued files
+    float getProgress() const;
+
+protected:
+    ResourceLoader();
+
+    struct Frame
+    {
+        std::string name;
+        cocos2d::Rect rect;             // in pixels, like the plist
+        bool rotated;
+        cocos2d::Vec2 offset;
+        cocos2d::Size originalSize;
+    };
+
+    struct Item
+    {
+        std::string file;               // as queued
+        std::string path;               // full path of the image, or of the plist until parsed
+        bool sheet;                     // a plist with its image
+        cocos2d::Image* image;          // decoded on a worker. nullptr on error
+        cocos2d::Texture2D* texture;    // uploaded. Retained by _textures
+        std::vector<Frame> frames;      // sprite frames of the image
+        size_t nextFrame;               // frames already added
+    };
+
+    void addItem(const std::string& file, bool sheet);
+    // worker thread
+    void decodeItem(Item& item);
+    bool parseSpriteFrames(Item& item);
+    // one step of main thread work. Returns false when the item is done
+    bool uploadStep(Item& item);
+
+    std::vector<Item> _queued;          // not started yet
+
+    std::unique_ptr<TaskPool> _pool;
+    std::mutex _mutex;
+    std::vector<Item> _decoded;         // ready for the main thread. Guarded by _mutex
+
+    std::vector<Item> _uploading;       // taken from _decoded, front first
+    std::set<std::string> _loaded;
+    int _finished;                      // loaded or failed
+    int _total;
+    bool _started;
+
+    cocos2d::Vector<cocos2d::Texture2D*> _textures;
+    cocos2d::Vector<cocos2d::SpriteFrame*> _frames;
+};
@@ -0,0 +1,153 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "TaskPool.h"
+
+#include <algorithm>
+
+// index of the worker running in this thread, -1 in other threads
+static thread_local int workerIndex = -1;
+static thread_local const TaskPool* workerPool = nullptr;
+
+TaskPool::TaskPool(int threads)
+: _queued(0)
+, _pending(0)
+, _next(0)
+, _quit(false)
+{
+    if (threads <= 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i=0; i<threads; i++)
+        _workers.emplace_back(new Worker);
+    for (int i=0; i<threads; i++)
+        _threads.emplace_back(&TaskPool::run, this, i);
+}
+
+TaskPool::~TaskPool()
+{
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _quit = true;
+    }
+    _wake.notify_all();
+    for (auto& thread : _threads)
+        thread.join();
+}
+
+void TaskPool::submit(std::function<void()> task)
+{
+    int index = (workerPool == this) ? workerIndex : (int)(_next++ % _workers.size());
+
+    _pending++;
+    {
+        std::lock_guard<std::mutex> lock(_workers[index]->mutex);
+        _workers[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queued++;
+    }
+    _wake.notify_one();
+}
+
+void TaskPool::wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this]() { return _pending == 0; });
+}
+
+void TaskPool::parallelFor(int count, const std::function<void(int)>& func, int grain)
+{
+    grain = std::max(grain, 1);
+    for (int begin=0; begin<count; begin+=grain)
+    {
+        int end = std::min(begin + grain, count);
+        submit([&func, begin, end]() {
+            for (int i=begin; i<end; i++)
+                func(i);
+        });
+    }
+    wait();
+}
+
+void TaskPool::run(int index)
+{
+    workerIndex = index;
+    workerPool = this;
+
+    std::function<void()> task;
+    while (true)
+    {
+        if (pop(index, task) || steal(index, task))
+        {
+            _queued--;
+            task();
+            task = nullptr;
+
+            if (--_pending == 0)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _done.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _wake.wait(lock, [this]() { return _quit || _queued > 0; });
+        if (_quit)
+            return;
+    }
+}
+
+bool TaskPool::pop(int index, std::function<void()>& task)
+{
+    // newest first: it is the one most likely in the cache
+    auto& worker = *_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty())
+        return false;
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool TaskPool::steal(int index, std::function<void()>& task)
+{
+    // oldest first: it is usually the biggest chunk of work left
+    int count = (int)_workers.size();
+    for (int i=1; i<count; i++)
+    {
+        auto& victim = *_workers[(index + i) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,82 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool for the headless tools.
+// Every worker has its own queue: it takes its newest task first and,
+// when it runs out, steals the oldest task of another worker. Tasks of
+// very different lengths (runs that die at once vs runs that survive
+// minutes) keep all the cores busy without a shared queue.
+class TaskPool
+{
+public:
+    // 0 threads: one per hardware thread
+    explicit TaskPool(int threads = 0);
+    ~TaskPool();
+
+    int getThreadCount() const { return (int)_threads.size(); }
+
+    // tasks submitted from a worker go to its own queue,
+    // the others are spread round robin
+    void submit(std::function<void()> task);
+    // blocks until all the submitted tasks have finished.
+    // Must not be called from a task
+    void wait();
+
+    // runs func(i) for every i in [0, count) and waits.
+    // 'grain' consecutive indices are run by the same task
+    void parallelFor(int count, const std::function<void(int)>& func, int grain = 1);
+
+protected:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void run(int index);
+    bool pop(int index, std::function<void()>& task);
+    bool steal(int index, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;      // there are queued tasks, or quit
+    std::condition_variable _done;      // all the tasks finished
+    std::atomic<int> _queued;           // tasks in the queues
+    std::atomic<int> _pending;          // tasks not finished yet
+    std::atomic<unsigned int> _next;    // round robin for the external submits
+    bool _quit;
+};
@@ -0,0 +1,129 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Tracer.h"
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+static long long now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// small and stable ids, in the order the threads record their first event
+static int getThreadId()
+{
+    static std::atomic<int> nextId(1);
+    static thread_local int id = nextId++;
+    return id;
+}
+
+Tracer* Tracer::getInstance()
+{
+    static Tracer instance;
+    return &instance;
+}
+
+Tracer::Tracer()
+: _next(0)
+, _start(now())
+{
+    for (auto& slot: _slots)
+        slot.sequence.store(0, std::memory_order_relaxed);
+}
+
+void Tracer::begin(const char* name)
+{
+    record(name, 'B');
+}
+
+void Tracer::end(const char* name)
+{
+    record(name, 'E');
+}
+
+void Tracer::record(const char* name, char phase)
+{
+    // the oldest events get overwritten
+    unsigned int number = _next++;
+    Slot& slot = _slots[number & (CAPACITY - 1)];
+    slot.sequence.store(number * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.timestamp.store(now() - _start, std::memory_order_relaxed);
+    slot.threadId.store(getThreadId(), std::memory_order_relaxed);
+    slot.phase.store(phase, std::memory_order_relaxed);
+    slot.sequence.store(number * 2 + 2, std::memory_order_release);
+}
+
+bool Tracer::writeFile(const std::string& path) const
+{
+    // snapshot first: an event is kept only if its slot holds the same
+    // complete event before and after the copy
+    unsigned int total = _next;
+    unsigned int count = total < CAPACITY ? total : CAPACITY;
+    std::vector<Event> events;
+    events.reserve(count);
+    for (unsigned int number = total - count; number != total; number++)
+    {
+        const Slot& slot = _slots[number & (CAPACITY - 1)];
+        unsigned int sequence = number * 2 + 2;
+        if (slot.sequence.load(std::memory_order_acquire) != sequence)
+            continue;
+        Event event = {
+            slot.name.load(std::memory_order_relaxed),
+            slot.timestamp.load(std::memory_order_relaxed),
+            slot.threadId.load(std::memory_order_relaxed),
+            slot.phase.load(std::memory_order_relaxed)
+        };
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+            events.push_back(event);
+    }
+
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+
+    fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    for (size_t i=0; i<events.size(); i++)
+    {
+        const Event& event = events[i];
+        fprintf(file, "{\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %lld, \"pid\": 1, \"tid\": %d}%s\n",
+                event.name, event.phase, event.timestamp, event.threadId, i + 1 < events.size() ? "," : "");
+    }
+    fprintf(file, "]}\n");
+    return fclose(file) == 0;
+}
+
+void Tracer::clear()
+{
+    // stale sequences could match the new event numbers
+    for (auto& slot: _slots)
+        slot.sequence.store(0, std::memory_order_relaxed);
+    _next = 0;
+}
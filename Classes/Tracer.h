@@ -0,0 +1,103 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+// Records begin/end events in a ring buffer and writes them in the
+// Chrome trace format (chrome://tracing, ui.perfetto.dev).
+// Unlike Profiler, it keeps every event, so single bad frames can be
+// inspected. Only the last CAPACITY events are kept.
+//
+// Any thread can record events. Names must be string literals: only
+// the pointer is stored.
+//
+// The events are compiled in only when PARKOUR_ENABLE_TRACER is defined
+// (cmake -DPARKOUR_TRACER=ON). Otherwise PARKOUR_TRACE() expands to nothing.
+class Tracer
+{
+public:
+    static const int CAPACITY = 1 << 16;    // must be a power of 2
+
+    static Tracer* getInstance();
+
+    void begin(const char* name);
+    void end(const char* name);
+
+    // writes the events in the buffer. Other threads can keep recording:
+    // the events are copied first, skipping the ones being overwritten
+    bool writeFile(const std::string& path) const;
+    // should be called when no other thread is recording
+    void clear();
+
+protected:
+    Tracer();
+
+    struct Event
+    {
+        const char* name;
+        long long timestamp;            // microseconds since the tracer was created
+        int threadId;
+        char phase;                     // 'B' or 'E'
+    };
+
+    // a slot of the ring buffer, guarded by a per-slot seqlock.
+    // The fields are atomics so that reading a slot that is being
+    // written is not a data race, just a torn copy that gets discarded
+    struct Slot
+    {
+        std::atomic<unsigned int> sequence; // 2n+2 once event n is complete, odd while writing
+        std::atomic<const char*> name;
+        std::atomic<long long> timestamp;
+        std::atomic<int> threadId;
+        std::atomic<char> phase;
+    };
+
+    void record(const char* name, char phase);
+
+    Slot _slots[CAPACITY];
+    std::atomic<unsigned int> _next;    // total events recorded
+    long long _start;
+};
+
+// begin/end event for the lifetime of the scope
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name) : _name(name) { Tracer::getInstance()->begin(name); }
+    ~TraceScope() { Tracer::getInstance()->end(_name); }
+
+protected:
+    const char* _name;
+};
+
+#ifdef PARKOUR_ENABLE_TRACER
+#define PARKOUR_TRACE_NAME2(line) _traceScope##line
+#define PARKOUR_TRACE_NAME(line) PARKOUR_TRACE_NAME2(line)
+#define PARKOUR_TRACE(name) TraceScope PARKOUR_TRACE_NAME(__LINE__)(name)
+#else
+#define PARKOUR_TRACE(name)
+#endif
@@ -0,0 +1,177 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "VectorEnv.h"
+
+#include <algorithm>
+
+#include "TaskPool.h"
+
+static const float DISTANCE_REWARD = 0.01f;     // per pixel
+static const float COIN_REWARD = 1;
+static const float DEATH_REWARD = -10;
+static const int STEP_GRAIN = 64;               // environments per task
+
+struct VectorEnv::Env : public World::Delegate
+{
+    Env() : seed(0), episodes(0), coins(0) {}
+
+    virtual void onCoinCollected() override { coins++; }
+
+    World world;
+    uint32_t seed;
+    long long episodes;
+    int coins;                          // collected in the current step
+};
+
+VectorEnv::VectorEnv(int count, const MapPack* mapPack, TaskPool* pool)
+: _observations(count * OBSERVATION_SIZE)
+, _rewards(count)
+, _dones(count)
+, _mapPack(mapPack)
+, _pool(pool)
+, _maxSteps(0)
+{
+    for (int i=0; i<count; i++)
+    {
+        _envs.emplace_back(new Env);
+        auto& env = *_envs.back();
+        env.world.setDelegate(&env);
+        env.world.setMapPack(_mapPack);
+    }
+}
+
+VectorEnv::~VectorEnv()
+{
+}
+
+void VectorEnv::reset(uint32_t seed)
+{
+    for (int i=0; i<getCount(); i++)
+    {
+        _envs[i]->seed = seed + i;
+        _envs[i]->episodes = 0;
+        resetEnv(i);
+        observe(i);
+        _rewards[i] = 0;
+        _dones[i] = 0;
+    }
+}
+
+void VectorEnv::step(const unsigned char* actions)
+{
+    if (_pool)
+    {
+        int tasks = (getCount() + STEP_GRAIN - 1) / STEP_GRAIN;
+        _pool->parallelFor(tasks, [this, actions](int task) {
+            int begin = task * STEP_GRAIN;
+            stepRange(begin, std::min(begin + STEP_GRAIN, getCount()), actions);
+        });
+    }
+    else
+    {
+        stepRange(0, getCount(), actions);
+    }
+}
+
+long long VectorEnv::getEpisodeCount() const
+{
+    long long episodes = 0;
+    for (auto& env : _envs)
+        episodes += env->episodes;
+    return episodes;
+}
+
+void VectorEnv::stepRange(int begin, int end, const unsigned char* actions)
+{
+    for (int i=begin; i<end; i++)
+    {
+        Env& env = *_envs[i];
+        World& world = env.world;
+
+        int score = world.getScore();
+        env.coins = 0;
+        world.setButtonPressed(actions[i] != 0);
+        world.step();
+
+        float reward = (world.getScore() - score) * DISTANCE_REWARD + env.coins * COIN_REWARD;
+        bool done = world.getActorMode() == World::GAMEOVER;
+        if (done)
+            reward += DEATH_REWARD;
+        else if (_maxSteps > 0 && world.getStepCount() >= _maxSteps)
+            done = true;
+
+        _rewards[i] = reward;
+        _dones[i] = done;
+        if (done)
+        {
+            env.episodes++;
+            env.seed += getCount();
+            resetEnv(i);
+        }
+        observe(i);
+    }
+}
+
+void VectorEnv::resetEnv(int index)
+{
+    Env& env = *_envs[index];
+    env.world.setSeed(env.seed);
+    env.world.reset();
+}
+
+void VectorEnv::observe(int index)
+{
+    const World& world = _envs[index]->world;
+    float* obs = &_observations[index * OBSERVATION_SIZE];
+
+    auto& pos = world.getActorPosition();
+    World::ActorMode mode = world.getActorMode();
+    obs[0] = pos.y;
+    obs[1] = world.getActorVelocity().y;
+    obs[2] = world.getGameSpeed();
+    for (int i=0; i<World::GAMEOVER; i++)
+        obs[3 + i] = (mode == i);
+    obs += ACTOR_FEATURES;
+
+    // objects are sorted by X: skip the ones already behind the actor
+    auto& objects = world.getObjects();
+    int count = 0;
+    for (int i=0; i<objects.size() && count<NEARBY_OBJECTS; i++)
+    {
+        if (!objects.alive[i] || objects.x[i] + objects.width[i] < pos.x)
+            continue;
+
+        bool coin = objects.type[i] == World::COIN;
+        obs[0] = objects.x[i] - pos.x;
+        obs[1] = objects.y[i];
+        obs[2] = objects.width[i];
+        obs[3] = objects.height[i];
+        obs[4] = coin;
+        obs[5] = !coin;
+        obs += OBJECT_FEATURES;
+        count++;
+    }
+    std::fill(obs, obs + (NEARBY_OBJECTS - count) * OBJECT_FEATURES, 0.0f);
+}
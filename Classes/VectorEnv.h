@@ -0,0 +1,100 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include "World.h"
+
+class MapPack;
+class TaskPool;
+
+// Reinforcement learning style environment over World, for bot training
+// and automated difficulty testing: N independent worlds stepped in
+// lockstep, with their observations, rewards and done flags in
+// contiguous arrays that can be handed to a training library as is.
+//
+// Action: 1 presses the button, 0 releases it.
+//
+// Observation, OBSERVATION_SIZE floats per environment:
+//   actor:   y, velocity y, game speed, then the mode one-hot
+//            (running, jumping up, jumping down, crouch)
+//   objects: the next NEARBY_OBJECTS alive objects in front of the actor,
+//            nearest first: x relative to the actor, y, width, height,
+//            is coin, is obstacle. Missing objects are all zeros
+//
+// Reward: pixels run / 100, plus 1 per coin, minus 10 when the run ends.
+//
+// Environments that end (game over or the step limit) are reset right
+// away with a new seed: the observation of that step is already the
+// first one of the new run, and its done flag is 1.
+class VectorEnv
+{
+public:
+    static const int NEARBY_OBJECTS = 8;
+    static const int ACTOR_FEATURES = 7;
+    static const int OBJECT_FEATURES = 6;
+    static const int OBSERVATION_SIZE = ACTOR_FEATURES + NEARBY_OBJECTS * OBJECT_FEATURES;
+
+    // 'mapPack' and 'pool' are optional and not owned. With a pool the
+    // environments are stepped in parallel
+    VectorEnv(int count, const MapPack* mapPack = nullptr, TaskPool* pool = nullptr);
+    ~VectorEnv();
+
+    int getCount() const { return (int)_envs.size(); }
+    // runs longer than this are ended. 0: no limit
+    void setMaxSteps(int maxSteps) { _maxSteps = maxSteps; }
+
+    // environment 'i' starts with seed + i. The next runs keep
+    // using consecutive seeds, 'count' apart
+    void reset(uint32_t seed);
+    // one action per environment
+    void step(const unsigned char* actions);
+
+    // count * OBSERVATION_SIZE floats
+    const float* getObservations() const { return _observations.data(); }
+    const float* getRewards() const { return _rewards.data(); }
+    const unsigned char* getDones() const { return _dones.data(); }
+    // runs finished since the last reset()
+    long long getEpisodeCount() const;
+
+protected:
+    struct Env;
+
+    void stepRange(int begin, int end, const unsigned char* actions);
+    void resetEnv(int index);
+    void observe(int index);
+
+    std::vector<std::unique_ptr<Env>> _envs;
+    std::vector<float> _observations;
+    std::vector<float> _rewards;
+    std::vector<unsigned char> _dones;
+
+    const MapPack* _mapPack;
+    TaskPool* _pool;
+    int _maxSteps;
+};
@@ -0,0 +1,167 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "Wav.h"
+
+#include <limits.h>
+#include <string.h>
+
+// the header of a canonical 16 bits PCM file
+struct WavHeader
+{
+    char riff[4];
+    uint32_t riffSize;
+    char wave[4];
+    char fmt[4];
+    uint32_t fmtSize;
+    uint16_t format;
+    uint16_t channels;
+    uint32_t sampleRate;
+    uint32_t byteRate;
+    uint16_t blockAlign;
+    uint16_t bitsPerSample;
+    char data[4];
+    uint32_t dataSize;
+};
+static_assert(sizeof(WavHeader) == 44, "WavHeader is part of the file format");
+
+static const uint16_t FORMAT_PCM = 1;
+
+struct ChunkHeader
+{
+    char id[4];
+    uint32_t size;
+};
+
+bool loadWav(const std::string& path, std::vector<int16_t>& samples, int& channels, int& sampleRate)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    // the size of the data chunk is checked against it before allocating
+    long fileSize = -1;
+    if (fseek(file, 0, SEEK_END) == 0)
+        fileSize = ftell(file);
+    if (fileSize < 0 || fseek(file, 0, SEEK_SET) != 0)
+    {
+        fclose(file);
+        return false;
+    }
+
+    // RIFF header, then chunks: "fmt " must come before "data"
+    char riff[12];
+    bool ok = fread(riff, sizeof(riff), 1, file) == 1 && memcmp(riff, "RIFF", 4) == 0 && memcmp(riff + 8, "WAVE", 4) == 0;
+    bool format = false;
+    ChunkHeader chunk;
+    while (ok && fread(&chunk, sizeof(chunk), 1, file) == 1)
+    {
+        if (memcmp(chunk.id, "fmt ", 4) == 0 && chunk.size >= 16)
+        {
+            uint16_t fmt[8];
+            ok = fread(fmt, 16, 1, file) == 1 && fseek(file, chunk.size - 16 + (chunk.size & 1), SEEK_CUR) == 0;
+            // format, channels, sample rate (2), byte rate (2), block align, bits per sample
+            ok = ok && fmt[0] == FORMAT_PCM && fmt[7] == 16 && fmt[1] >= 1 && fmt[1] <= 2;
+            uint32_t rate = fmt[2] | ((uint32_t)fmt[3] << 16);
+            ok = ok && rate > 0 && rate <= INT_MAX;
+            channels = fmt[1];
+            sampleRate = (int)rate;
+            format = ok;
+        }
+        else if (memcmp(chunk.id, "data", 4) == 0 && format)
+        {
+            long position = ftell(file);
+            if (position < 0 || chunk.size > (unsigned long)(fileSize - position))
+                break;
+            samples.resize(chunk.size / sizeof(int16_t));
+            ok = fread(samples.data(), sizeof(int16_t), samples.size(), file) == samples.size();
+            fclose(file);
+            return ok;
+        }
+        else
+        {
+            ok = fseek(file, chunk.size + (chunk.size & 1), SEEK_CUR) == 0;
+        }
+    }
+    fclose(file);
+    return false;
+}
+
+WavWriter::WavWriter()
+: _file(nullptr)
+, _channels(0)
+, _sampleRate(0)
+, _frames(0)
+{
+}
+
+WavWriter::~WavWriter()
+{
+    close();
+}
+
+bool WavWriter::open(const std::string& path, int channels, int sampleRate)
+{
+    close();
+    _file = fopen(path.c_str(), "wb");
+    if (!_file)
+        return false;
+
+    _channels = channels;
+    _sampleRate = sampleRate;
+    _frames = 0;
+
+    // the sizes are written by close()
+    WavHeader header = {};
+    return fwrite(&header, sizeof(header), 1, _file) == 1;
+}
+
+bool WavWriter::write(const int16_t* samples, int frames)
+{
+    if (!_file)
+        return false;
+    _frames += frames;
+    return fwrite(samples, sizeof(int16_t) * _channels, frames, _file) == (size_t)frames;
+}
+
+bool WavWriter::close()
+{
+    if (!_file)
+        return false;
+
+    uint32_t dataSize = (uint32_t)(_frames * _channels * sizeof(int16_t));
+    WavHeader header = {
+        {'R', 'I', 'F', 'F'}, (uint32_t)(sizeof(WavHeader) - 8 + dataSize),
+        {'W', 'A', 'V', 'E'},
+        {'f', 'm', 't', ' '}, 16,
+        FORMAT_PCM, (uint16_t)_channels, (uint32_t)_sampleRate,
+        (uint32_t)(_sampleRate * _channels * sizeof(int16_t)),
+        (uint16_t)(_channels * sizeof(int16_t)), 16,
+        {'d', 'a', 't', 'a'}, dataSize,
+    };
+    bool ok = fseek(_file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, _file) == 1;
+    ok = fclose(_file) == 0 && ok;
+    _file = nullptr;
+    return ok;
+}
@@ -0,0 +1,58 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+// Minimal RIFF WAVE support for the headless audio tools.
+// 16 bits PCM only, little endian.
+
+// interleaved samples of all the channels
+bool loadWav(const std::string& path, std::vector<int16_t>& samples, int& channels, int& sampleRate);
+
+// Writes 16 bits PCM to a .wav file: the sound device of the headless
+// mixer. The sizes of the header are written when it is closed.
+class WavWriter
+{
+public:
+    WavWriter();
+    ~WavWriter();
+
+    bool open(const std::string& path, int channels, int sampleRate);
+    // 'frames' frames of interleaved samples
+    bool write(const int16_t* samples, int frames);
+    bool close();
+
+    long long getFrames() const { return _frames; }
+
+protected:
+    FILE* _file;
+    int _channels;
+    int _sampleRate;
+    long long _frames;
+};
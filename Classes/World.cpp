@@ -0,0 +1,551 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "World.h"
+
+#include <algorithm>
+
+#include "InputJournal.h"
+#include "ObjectKernels.h"
+#include "Profiler.h"
+#include "Tracer.h"
+
+static const float FOREGROUND_SPEED = 250;      // pixels per second
+static const float ACTOR_POS_X = 30;
+static const float ACTOR_POS_Y = 60;
+static const float JUMP_VEL_Y = 4.5;
+static const float GRAVITY_Y = 2.5;
+static const float BUTTON_MAX_TIME = 0.4;       // max seconds that button can be pressed
+static const float GO_DOWN_VEL_Y = -3;          // initial velocity when falling
+static const float CROUCH_VEL_Y = -8;           // landings faster than this crouch the actor
+static const double CROUCH_TIME = 0.15;         // seconds crouching after a hard landing
+static const float MAX_FRAME_TIME = 0.25;       // longer frames are clamped to avoid a "spiral of death"
+static const float SPAWN_LOOKAHEAD = 128;       // objects are spawned when they are this close to the screen
+static const int SPAWN_BUDGET = 8;              // max objects spawned per step
+static const float CHUNK_GAP = 168;             // pixels in between two maps
+
+const float World::FIXED_DT = 1.0f / 60;
+
+// built-in maps are spawned the same way as the compiled ones
+static CompiledMap toCompiledMap(const Map* map, const std::vector<MapEntity>& entities)
+{
+    return {entities.data(), (int)entities.size(), map->buffer_size, map->item_size};
+}
+
+bool World::Rect::intersects(const Rect& rect) const
+{
+    return !(x + width < rect.x ||
+             rect.x + rect.width < x ||
+             y + height < rect.y ||
+             rect.y + rect.height < y);
+}
+
+World::Config::Config()
+: screenWidth(480)
+{
+    actorSize[RUNNING] = {62, 56};
+    actorSize[JUMPING_UP] = {62, 56};
+    // the jump down animation uses the jump up frames
+    actorSize[JUMPING_DOWN] = {62, 56};
+    actorSize[CROUCH] = {39, 38};
+
+    objectSize[COIN] = {36, 36};
+    objectSize[BOX] = {56, 44};
+    objectSize[ANVIL] = {56, 44};
+}
+
+World::World()
+: _maxObjectWidth(0)
+, _delegate(nullptr)
+, _mapPack(nullptr)
+, _journal(nullptr)
+, _seed(1)
+, _random(_seed)
+, _chunk({nullptr, 0, {0, 0}, {0, 0}})
+, _chunkMap(0)
+, _chunkNext(0)
+, _chunkX(0)
+, _elapsedPixels(0)
+, _gameSpeed(FOREGROUND_SPEED)
+, _scrollDistance(0)
+, _scrollDx(0)
+, _accumulator(0)
+, _stepCount(0)
+, _buttonPressedTime(0)
+, _buttonPressed(false)
+, _actorMode(GAMEOVER)
+, _actorSize(_config.actorSize[RUNNING])
+, _actorPos({ACTOR_POS_X, ACTOR_POS_Y})
+, _actorVel({0, 0})
+, _prevActorPos(_actorPos)
+, _death({BOX, 0, 0, 0, RUNNING})
+, _accelTime(0)
+, _elapsedTime(0)
+{
+    setConfig(_config);
+}
+
+World::World(const Config& config)
+: World()
+{
+    setConfig(config);
+}
+
+void World::setConfig(const Config& config)
+{
+    _config = config;
+
+    _maxObjectWidth = 0;
+    for (int i=0; i<OBJECT_TYPES; i++)
+        _maxObjectWidth = std::max(_maxObjectWidth, _config.objectSize[i].width);
+}
+
+void World::setSeed(uint32_t seed)
+{
+    _seed = seed;
+}
+
+void World::reset()
+{
+    // the view should release the objects from the previous run
+    removeObjects(_objects.size());
+
+    // every run starts from its seed, so it can be replayed alone
+    _random.setSeed(_seed);
+    if (_journal)
+        _journal->start(_seed, _config, _mapPack ? _mapPack->getHash() : 0);
+
+    _elapsedPixels = 0;
+    _gameSpeed = FOREGROUND_SPEED;
+    _scrollDistance = 0;
+    _scrollDx = 0;
+    _accumulator = 0;
+    _stepCount = 0;
+
+    _buttonPressed = false;
+    _buttonPressedTime = 0;
+
+    _actorPos = {ACTOR_POS_X, ACTOR_POS_Y};
+    _prevActorPos = _actorPos;
+    _accelTime = 0;
+    _elapsedTime = 0;
+    actorRun();
+
+    // Get Ready Map at the beginning of the level
+    queueMap(0, _config.screenWidth);
+    addObjects(0);
+}
+
+int World::advance(float dt)
+{
+    if (dt > MAX_FRAME_TIME)
+        dt = MAX_FRAME_TIME;
+
+    _accumulator += dt;
+
+    int steps = 0;
+    while (_accumulator >= FIXED_DT)
+    {
+        step();
+        _accumulator -= FIXED_DT;
+        steps++;
+    }
+    return steps;
+}
+
+void World::step()
+{
+    PARKOUR_PROFILE(STEP);
+
+    if (_actorMode != GAMEOVER)
+    {
+        const float dt = FIXED_DT;
+
+        _stepCount++;
+        _prevActorPos = _actorPos;
+
+        // accelerate game
+        _gameSpeed += dt * 2;
+
+        processEvents(dt);
+        updateScroll(dt);
+        updateActor(dt);
+        updateObjects(dt);
+        updateScore(dt);
+        checkCollisions(dt);
+    }
+}
+
+void World::setButtonPressed(bool pressed)
+{
+    // changes only. Repeating the current state has no effect
+    if (pressed == _buttonPressed)
+        return;
+
+    _buttonPressed = pressed;
+    if (_journal)
+        _journal->record(_stepCount, pressed);
+}
+
+World::Vec2 World::getActorPosition(float alpha) const
+{
+    return {_prevActorPos.x + (_actorPos.x - _prevActorPos.x) * alpha,
+            _prevActorPos.y + (_actorPos.y - _prevActorPos.y) * alpha};
+}
+
+double World::getScrollDistance(float alpha) const
+{
+    return _scrollDistance - _scrollDx * (1 - alpha);
+}
+
+float World::getObjectX(int index, float alpha) const
+{
+    // all the objects scroll at the same speed
+    return _objects.x[index] + getObjectOffsetX(alpha);
+}
+
+void World::processEvents(float dt)
+{
+    PARKOUR_PROFILE(PROCESS_EVENTS);
+
+    if (_actorMode == RUNNING || _actorMode == CROUCH)
+    {
+        if (_buttonPressed)
+        {
+            actorJump();
+            _buttonPressedTime = 0;
+        }
+    }
+}
+
+void World::updateScore(float dt)
+{
+    PARKOUR_PROFILE(UPDATE_SCORE);
+
+    _elapsedPixels += dt * _gameSpeed;
+}
+
+void World::updateScroll(float dt)
+{
+    PARKOUR_PROFILE(UPDATE_SCROLL);
+
+    _scrollDx = dt * _gameSpeed;
+    _scrollDistance += _scrollDx;
+}
+
+void World::updateActor(float dt)
+{
+    PARKOUR_PROFILE(UPDATE_ACTOR);
+
+    if (_buttonPressed) {
+        _buttonPressedTime += dt;
+
+        if (_buttonPressedTime > BUTTON_MAX_TIME) {
+            _buttonPressed = false;
+        }
+    }
+
+    if (_actorMode==JUMPING_UP)
+    {
+        _accelTime += dt;
+
+        // reduce gravity while button is pressed
+        if (_buttonPressed)
+            _actorVel.y -= (GRAVITY_Y *0.01) * _accelTime;
+        else
+            _actorVel.y -= GRAVITY_Y * _accelTime;
+
+        _actorPos.y += _actorVel.y;
+
+        // started going down ?
+        if (_actorVel.y <= 0)
+            actorGoDown();
+    }
+    else if (_actorMode==JUMPING_DOWN)
+    {
+        _accelTime += dt;
+        _actorVel.y -= GRAVITY_Y * _accelTime;
+
+        _actorPos.y += _actorVel.y;
+
+        if (_actorPos.y <= ACTOR_POS_Y) {
+            _actorPos.y = ACTOR_POS_Y;
+            if (_actorVel.y < CROUCH_VEL_Y)
+                actorCrouch();
+            else
+                actorRun();
+        }
+    }
+    else if (_actorMode==CROUCH)
+    {
+        _elapsedTime += dt;
+        if (_elapsedTime > CROUCH_TIME)
+            actorRun();
+    }
+}
+
+void World::updateObjects(float dt)
+{
+    PARKOUR_PROFILE(UPDATE_OBJECTS);
+
+    // 1 - scroll objects
+    float dx = dt * _gameSpeed;
+    _objects.scroll(dx);
+    _chunkX -= dx;
+
+    // 2 - remove objects no longer visible
+
+    // objects are ordered in X
+    // if an object is still in the screen, it is safe
+    // to assume that the rest of the objects are still inside the
+    // screen too.
+    int count = 0;
+    while (count < _objects.size() && _objects.x[count] + _objects.width[count] + 50 < 0)
+        count++;
+
+    if (count > 0)
+        removeObjects(count);
+
+    addObjects(dt);
+}
+
+void World::checkCollisions(float dt)
+{
+    PARKOUR_PROFILE(CHECK_COLLISIONS);
+
+    // reduce BB by some pixels in X
+    Rect actorBB = {_actorPos.x + 30, _actorPos.y, _actorSize.width - 50, _actorSize.height};
+
+    // broadphase: objects are sorted by their X position and none of them
+    // is wider than _maxObjectWidth, so only the ones in between
+    // [actor.x - _maxObjectWidth, actor.x + actor.width] can collide.
+    // 1 extra pixel to be safe with rounding errors
+    float minX = actorBB.x - _maxObjectWidth - 1;
+    float maxX = actorBB.x + actorBB.width;
+    int first = (int)(std::lower_bound(_objects.x.begin(), _objects.x.end(), minX) - _objects.x.begin());
+    int last = (int)(std::upper_bound(_objects.x.begin() + first, _objects.x.end(), maxX) - _objects.x.begin());
+    int count = last - first;
+
+    // narrow phase: test all the candidates at once
+    if ((int)_hits.size() < count)
+        _hits.resize(count);
+    intersectObjects(_objects.x.data() + first, _objects.y.data() + first,
+                     _objects.width.data() + first, _objects.height.data() + first, count,
+                     actorBB.x, actorBB.y, actorBB.width, actorBB.height,
+                     _hits.data());
+
+    bool collision = false;
+    for (int i=first; i<last; i++)
+    {
+        if (!_hits[i-first] || !_objects.alive[i])
+            continue;
+
+        Rect objbb = {_objects.x[i], _objects.y[i], _objects.width[i], _objects.height[i]};
+
+        collision = true;
+        ObjectType objType = (ObjectType)_objects.type[i];
+        if (objType == COIN) {
+            killObject(i);
+            if (_delegate)
+                _delegate->onCoinCollected();
+        }
+        else if (objType == BOX || objType == ANVIL)
+        {
+            // actor can run on top boxes, but a right collision is game over
+            // actor on top, and the collision is no bigger than 10 pixels
+            if ((objbb.y + objbb.height - _prevActorPos.y) < 0)
+            {
+                _actorPos.y = objbb.y + objbb.height;
+                actorRun();
+            }
+            else if (_actorVel.y==0 && (objbb.y + objbb.height - actorBB.y) == 0)
+            {
+                // skip
+            }
+            else
+            {
+                _death = {objType, _objects.map[i], _objects.column[i], _objects.row[i], _actorMode};
+                gameOver();
+                break;
+            }
+        }
+    }
+
+    // running and no collision? and not on the ground ? then go down
+    if (!collision && _actorMode==RUNNING && actorBB.y > ACTOR_POS_Y)
+        actorGoDown();
+}
+
+void World::gameOver()
+{
+    // freeze the interpolation in the last step
+    _scrollDx = 0;
+    _prevActorPos = _actorPos;
+
+    if (_journal)
+        _journal->finish(_stepCount, getScore());
+
+    setActorMode(GAMEOVER);
+}
+
+void World::actorJump()
+{
+    _actorVel = {0, JUMP_VEL_Y};          // pixels per step going up
+    _accelTime = 0;
+    setActorMode(JUMPING_UP);
+}
+
+void World::actorGoDown()
+{
+    _accelTime = 0;
+    if (_actorVel.y >= 0) {
+        _actorVel.y = GO_DOWN_VEL_Y;
+    }
+    setActorMode(JUMPING_DOWN);
+}
+
+void World::actorRun()
+{
+    _actorVel = {0, 0};
+    setActorMode(RUNNING);
+}
+
+void World::actorCrouch()
+{
+    _elapsedTime = 0;
+    _actorVel = {0, 0};
+    setActorMode(CROUCH);
+}
+
+void World::setActorMode(ActorMode mode)
+{
+    _actorMode = mode;
+    if (mode != GAMEOVER)
+        _actorSize = _config.actorSize[mode];
+
+    if (_delegate)
+        _delegate->onActorModeChanged(mode);
+}
+
+void World::addObjects(float dt)
+{
+    // spawn the objects of the chunk that entered the look-ahead window.
+    // No more than SPAWN_BUDGET per step, so a big map is spread across
+    // several steps instead of creating all its sprites in one frame
+    float maxX = _config.screenWidth + SPAWN_LOOKAHEAD;
+    int budget = SPAWN_BUDGET;
+
+    // most steps have nothing to spawn nor queue: only trace the ones that do.
+    // Same tests as the loop below
+    float firstX = _chunkNext < _chunk.entityCount
+        ? _chunkX + _chunk.entities[_chunkNext].column * _chunk.item_size.width
+        : _chunkX + _chunk.buffer_size.width * _chunk.item_size.width + CHUNK_GAP;
+    if (firstX > maxX)
+        return;
+    PARKOUR_TRACE("World::addObjects");
+
+    while (budget > 0)
+    {
+        if (_chunkNext == _chunk.entityCount)
+        {
+            // chunk fully spawned: the next one goes right after it
+            float nextX = _chunkX + _chunk.buffer_size.width * _chunk.item_size.width + CHUNK_GAP;
+            if (nextX > maxX)
+                break;
+            queueMap(getNextMap(), nextX);
+            continue;
+        }
+
+        const MapEntity& entity = _chunk.entities[_chunkNext];
+        float x = _chunkX + entity.column * _chunk.item_size.width;
+        if (x > maxX)
+            break;
+
+        addObject((ObjectType)entity.type, x, entity.column, entity.row, _chunk.item_size);
+        _chunkNext++;
+        budget--;
+    }
+}
+
+void World::queueMap(int map, float x)
+{
+    _chunk = getCompiledMap(map);
+    _chunkMap = map;
+    _chunkNext = 0;
+    _chunkX = x;
+
+    if (_delegate)
+        _delegate->onMapQueued(map);
+}
+
+int World::getNextMap()
+{
+    // map 0 is the Get Ready one
+    int count = getMapCount();
+    return count > 1 ? 1 + _random.nextInt(count - 1) : 0;
+}
+
+int World::getMapCount() const
+{
+    return _mapPack ? _mapPack->getMapCount() : ::getMapCount() + 1;
+}
+
+CompiledMap World::getCompiledMap(int map) const
+{
+    if (_mapPack)
+        return _mapPack->getMap(map);
+    if (map == 0)
+        return toCompiledMap(getGetReadyMap(), getGetReadyEntities());
+    return toCompiledMap(getMap(map - 1), getMapEntities(map - 1));
+}
+
+void World::addObject(ObjectType type, float x, int column, int row, const MapSize& item_size)
+{
+    // objects spawned on different steps may differ in the last bit.
+    // Keep the store sorted
+    if (!_objects.empty() && x < _objects.x.back())
+        x = _objects.x.back();
+
+    const MapSize& size = _config.objectSize[type];
+    _objects.push(type, x, ACTOR_POS_Y + row * item_size.height, size.width, size.height, column, row, _chunkMap);
+
+    if (_delegate)
+        _delegate->onObjectAdded(_objects.size() - 1);
+}
+
+void World::killObject(int index)
+{
+    _objects.kill(index);
+
+    if (_delegate)
+        _delegate->onObjectKilled(index);
+}
+
+void World::removeObjects(int count)
+{
+    _objects.eraseFront(count);
+
+    if (_delegate)
+        _delegate->onObjectsRemoved(count);
+}
@@ -0,0 +1,238 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "Map.h"
+#include "MapPack.h"
+#include "ObjectStore.h"
+#include "Random.h"
+
+class InputJournal;
+
+// World is the gameplay simulation: actor physics, scrolling objects,
+// map spawning and collisions.
+// It is plain C++ (no Director, no GL) and it is advanced at a fixed
+// timestep, so it can run on headless boxes and the jump height
+// doesn't depend on the frame rate.
+// GameNode is just a view of it.
+class World
+{
+public:
+    enum ActorMode {
+        RUNNING,
+        JUMPING_UP,
+        JUMPING_DOWN,
+        CROUCH,
+        GAMEOVER
+    };
+
+    enum ObjectType {
+        COIN = 0,
+        BOX = 1,
+        ANVIL = 2,
+        OBJECT_TYPES
+    };
+
+    struct Vec2
+    {
+        float x;
+        float y;
+    };
+
+    struct Rect
+    {
+        float x;
+        float y;
+        float width;
+        float height;
+
+        // same semantics as cocos2d::Rect::intersectsRect
+        bool intersects(const Rect& rect) const;
+    };
+
+    // sizes are in points. The defaults are the ones of "res-small",
+    // which is the design resolution. GameNode fills them from the sprite frames.
+    struct Config
+    {
+        Config();
+
+        float screenWidth;
+        MapSize actorSize[GAMEOVER];        // one per mode. First frame of the mode's animation
+        MapSize objectSize[OBJECT_TYPES];
+    };
+
+    // the view gets notified of the changes with these callbacks
+    class Delegate
+    {
+    public:
+        virtual ~Delegate() {}
+        // called everytime the actor changes its mode, even if it is the same one
+        virtual void onActorModeChanged(ActorMode mode) {}
+        // a new object was appended at the end of the object store
+        virtual void onObjectAdded(int index) {}
+        // object at 'index' is no longer alive. Indices don't change
+        virtual void onObjectKilled(int index) {}
+        // the first 'count' objects were removed. The rest were shifted
+        virtual void onObjectsRemoved(int count) {}
+        virtual void onCoinCollected() {}
+        // the objects of 'map' are going to be spawned next
+        virtual void onMapQueued(int map) {}
+    };
+
+    // what ended the run
+    struct Death
+    {
+        ObjectType type;                // BOX or ANVIL
+        int map;
+        int column;
+        int row;
+        ActorMode actorMode;            // what the actor was doing
+    };
+
+    // simulation step, in seconds
+    static const float FIXED_DT;
+
+    World();
+    explicit World(const Config& config);
+
+    void setConfig(const Config& config);
+    const Config& getConfig() const { return _config; }
+    void setDelegate(Delegate* delegate) { _delegate = delegate; }
+    // spawns the maps of a compiled pack instead of the built-in ones.
+    // nullptr goes back to the built-in maps. The pack must outlive the world
+    void setMapPack(const MapPack* mapPack) { _mapPack = mapPack; }
+    const MapPack* getMapPack() const { return _mapPack; }
+
+    // seed of the generator that picks the maps, used from the next reset().
+    // The same seed and the same inputs on the same steps give exactly the same run
+    void setSeed(uint32_t seed);
+    uint32_t getSeed() const { return _seed; }
+    // the runs are recorded in the journal, if any. Not owned
+    void setJournal(InputJournal* journal) { _journal = journal; }
+    InputJournal* getJournal() const { return _journal; }
+
+    // starts a new run with the "Get Ready" map.
+    // Until it is called the world is in GAMEOVER mode
+    void reset();
+
+    // advances the simulation 'dt' seconds of wall time, using as many
+    // fixed steps as needed. Returns the number of steps.
+    int advance(float dt);
+    // advances the simulation exactly one fixed step
+    void step();
+
+    void setButtonPressed(bool pressed);
+
+    // how far in between the previous and the current step is the wall time.
+    // Useful to interpolate the rendering
+    float getInterpolationAlpha() const { return _accumulator / FIXED_DT; }
+
+    ActorMode getActorMode() const { return _actorMode; }
+    const Vec2& getActorPosition() const { return _actorPos; }
+    Vec2 getActorPosition(float alpha) const;
+    // pixels per step
+    const Vec2& getActorVelocity() const { return _actorVel; }
+    float getGameSpeed() const { return _gameSpeed; }
+    // steps simulated since the last reset
+    int getStepCount() const { return _stepCount; }
+    int getScore() const { return _elapsedPixels; }
+    double getScrollDistance(float alpha) const;
+
+    // maps are identified by their index: 0 is the Get Ready map,
+    // the rest are the random ones. Same indices as the map pack, if any
+    int getMapCount() const;
+    // valid in GAMEOVER mode
+    const Death& getDeath() const { return _death; }
+
+    // the source of truth of the objects. The view should only mirror them
+    const ObjectStore& getObjects() const { return _objects; }
+    // X position of the object interpolated with the previous step
+    float getObjectX(int index, float alpha) const;
+    // all the objects scroll together: getObjectX() is objects.x plus this
+    float getObjectOffsetX(float alpha) const { return _scrollDx * (1 - alpha); }
+
+protected:
+    void processEvents(float dt);
+    void updateScroll(float dt);
+    void updateActor(float dt);
+    void updateObjects(float dt);
+    void updateScore(float dt);
+    void checkCollisions(float dt);
+
+    void addObjects(float dt);
+    void queueMap(int map, float x);
+    int getNextMap();
+    CompiledMap getCompiledMap(int map) const;
+    void addObject(ObjectType type, float x, int column, int row, const MapSize& item_size);
+    void killObject(int index);
+    void removeObjects(int count);
+
+    void actorJump();
+    void actorGoDown();
+    void actorRun();
+    void actorCrouch();
+    void gameOver();
+    void setActorMode(ActorMode mode);
+
+    Config _config;
+    float _maxObjectWidth;              // used by the collisions broadphase
+    Delegate* _delegate;
+    const MapPack* _mapPack;
+    InputJournal* _journal;
+    uint32_t _seed;
+    Random _random;
+
+    ObjectStore _objects;
+
+    // maps are streamed: their objects are spawned a few at a time,
+    // as they get close to the right edge of the screen
+    CompiledMap _chunk;                 // map being spawned
+    int _chunkMap;                      // its index
+    int _chunkNext;                     // next entity of _chunk to spawn
+    float _chunkX;                      // X position of the first column of _chunk
+    std::vector<unsigned char> _hits;   // collisions mask. Reused every step to prevent allocations
+
+    int _elapsedPixels;                 // score will be based on this ivar
+    float _gameSpeed;
+    double _scrollDistance;             // total scrolled pixels
+    float _scrollDx;                    // pixels scrolled in the last step
+
+    float _accumulator;                 // wall time not simulated yet
+    int _stepCount;
+
+    float _buttonPressedTime;           // for how long the button was pressed
+    bool _buttonPressed;                // pressed or released ?
+
+    ActorMode _actorMode;
+    MapSize _actorSize;
+    Vec2 _actorPos;
+    Vec2 _actorVel;
+    Vec2 _prevActorPos;                 // useful for collision detection
+    Death _death;
+    float _accelTime;
+    float _elapsedTime;                 // calculates elapsed time for crouch mode
+};
@@ -0,0 +1,175 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Sound effects of bot runs played through AudioDispatcher, with a fake
+// audio backend that takes a while for every effect (like the platform
+// ones sometimes do). Frames are paced at --fps so the audio thread
+// keeps up like in the game.
+// Reports the time the game thread spends on the effects, synchronous
+// vs dispatched, and the metrics of the dispatcher.
+//
+//   audio_dispatch_benchmark [--frames N] [--fps F] [--backend-us U]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "AudioDispatcher.h"
+#include "Bot.h"
+#include "World.h"
+
+enum Effect {
+    JUMP,
+    PICKUP_COIN,
+};
+
+typedef std::chrono::steady_clock Clock;
+
+// busy: a sleep would be rounded to the scheduler tick
+static void fakeBackend(int microseconds)
+{
+    auto end = Clock::now() + std::chrono::microseconds(microseconds);
+    while (Clock::now() < end)
+        ;
+}
+
+// the effects GameNode plays, one vector per frame
+class EffectsDelegate : public World::Delegate
+{
+public:
+    virtual void onActorModeChanged(World::ActorMode mode) override
+    {
+        if (mode == World::JUMPING_UP)
+            frame.push_back(JUMP);
+    }
+    virtual void onCoinCollected() override { frame.push_back(PICKUP_COIN); }
+
+    std::vector<int> frame;
+};
+
+static std::vector<std::vector<int>> recordEffects(int frames)
+{
+    std::vector<std::vector<int>> effects;
+    EffectsDelegate delegate;
+    World world;
+    world.setDelegate(&delegate);
+    Bot bot;
+    for (int run=0; (int)effects.size() < frames; run++)
+    {
+        world.setSeed(run + 1);
+        world.reset();
+        while (world.getActorMode() != World::GAMEOVER && (int)effects.size() < frames)
+        {
+            delegate.frame.clear();
+            world.setButtonPressed(bot.update(world));
+            world.advance(1 / 60.0f);
+            effects.push_back(delegate.frame);
+        }
+    }
+    return effects;
+}
+
+int main(int argc, char** argv)
+{
+    int frames = 6000;
+    double fps = 1200;
+    int backendMicroseconds = 300;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "--frames") == 0 && i+1 < argc)
+            frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--fps") == 0 && i+1 < argc)
+            fps = atof(argv[++i]);
+        else if (strcmp(argv[i], "--backend-us") == 0 && i+1 < argc)
+            backendMicroseconds = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: audio_dispatch_benchmark [--frames N] [--fps F] [--backend-us U]\n");
+            return 1;
+        }
+    }
+
+    auto effects = recordEffects(frames);
+    long long count = 0;
+    for (auto& frame : effects)
+        count += frame.size();
+
+    // synchronous: what GameNode did
+    double synchronousMax = 0;
+    auto start = Clock::now();
+    for (auto& frame : effects)
+    {
+        auto frameStart = Clock::now();
+        for (size_t i=0; i<frame.size(); i++)
+            fakeBackend(backendMicroseconds);
+        std::chrono::duration<double> elapsed = Clock::now() - frameStart;
+        synchronousMax = std::max(synchronousMax, elapsed.count());
+    }
+    std::chrono::duration<double> synchronous = Clock::now() - start;
+
+    // dispatched, paced like the game
+    std::atomic<long long> played(0);
+    double dispatchedTotal = 0;
+    double dispatchedMax = 0;
+    AudioDispatcher::Metrics metrics;
+    {
+        AudioDispatcher dispatcher([&](int effect){
+            fakeBackend(backendMicroseconds);
+            played++;
+        });
+
+        auto frameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1 / fps));
+        auto next = Clock::now();
+        for (auto& frame : effects)
+        {
+            auto frameStart = Clock::now();
+            for (int effect : frame)
+                dispatcher.post(effect);
+            dispatcher.flush();
+            std::chrono::duration<double> elapsed = Clock::now() - frameStart;
+            dispatchedTotal += elapsed.count();
+            dispatchedMax = std::max(dispatchedMax, elapsed.count());
+
+            next += frameTime;
+            std::this_thread::sleep_until(next);
+        }
+        // the destructor plays what is left
+        metrics = dispatcher.getMetrics();
+    }
+
+    printf("%d frames at %.0f fps, %lld effects, backend %d us per effect\n", frames, fps, count, backendMicroseconds);
+    printf("game thread, us per frame (average / worst):\n");
+    printf("  synchronous:  %8.3f / %8.1f\n", synchronous.count() * 1e6 / frames, synchronousMax * 1e6);
+    printf("  dispatched:   %8.3f / %8.1f\n", dispatchedTotal * 1e6 / frames, dispatchedMax * 1e6);
+    printf("dispatcher: posted %lld, coalesced %lld, dropped %lld, played %lld (%lld at exit)\n",
+           metrics.posted, metrics.coalesced, metrics.dropped, metrics.played, (long long)played);
+    printf("queue depth max %d, latency average %.1f us, max %.1f us\n",
+           metrics.maxQueueDepth, metrics.averageLatency * 1e6, metrics.maxLatency * 1e6);
+    return 0;
+}
@@ -0,0 +1,96 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Cost of World::checkCollisions() vs the number of objects.
+// It compares the sorted-by-X broadphase with testing every object,
+// which is what checkCollisions used to do.
+
+#include <stdio.h>
+#include <chrono>
+
+#include "World.h"
+
+class BenchmarkWorld : public World
+{
+public:
+    // boxes above the actor, spaced like the map tiles.
+    // Half of them are behind the actor and half in front of it.
+    // They overlap its X span, but they never collide with it
+    void fill(int count)
+    {
+        reset();
+        _objects.clear();
+        for (int i=0; i<count; i++)
+            _objects.push(BOX, 60 + (i - count/2) * 28.0f, 400, 56, 44, i, 0);
+    }
+
+    int testAll() const
+    {
+        Rect actorBB = {_actorPos.x + 30, _actorPos.y, _actorSize.width - 50, _actorSize.height};
+        int hits = 0;
+        for (int i=0; i<_objects.size(); i++)
+        {
+            Rect rect = {_objects.x[i], _objects.y[i], _objects.width[i], _objects.height[i]};
+            if (actorBB.intersects(rect))
+                hits++;
+        }
+        return hits;
+    }
+
+    void broadphase()
+    {
+        checkCollisions(FIXED_DT);
+    }
+};
+
+template <typename F>
+static double nanosPerCall(int iterations, F func)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i=0; i<iterations; i++)
+        func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+int main(int argc, char** argv)
+{
+    const int counts[] = {10, 30, 100, 300, 1000, 3000, 10000};
+
+    printf("%10s %16s %16s\n", "objects", "test all (ns)", "broadphase (ns)");
+
+    BenchmarkWorld world;
+    for (int count: counts)
+    {
+        world.fill(count);
+
+        const int iterations = 20000000 / count + 1000;
+        volatile int sink = 0;
+        double all = nanosPerCall(iterations, [&]() { sink += world.testAll(); });
+        double broadphase = nanosPerCall(iterations, [&]() { world.broadphase(); });
+
+        printf("%10d %16.1f %16.1f\n", count, all, broadphase);
+    }
+    return 0;
+}
@@ -0,0 +1,207 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Plays the game headless with a scripted bot, as fast as possible:
+// actor physics, scrolling, map spawning and collisions. No GL view.
+//
+//   game_benchmark [--runs N] [--seconds S] [--pack maps.pkm]
+//                  [--min-fps F] [--max-allocs A]
+//
+// Every run is seeded with its index and lasts until game over, which
+// takes about 9 simulated seconds with the bot. S only caps the runs
+// (120 by default), it doesn't set their length. Reports simulated
+// frames (steps) per second and
+// heap allocations per frame. --min-fps and --max-allocs make it exit
+// with 1 when the results are worse, so releases can be gated on it.
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <string>
+
+#include "Bot.h"
+#include "MapPack.h"
+#include "World.h"
+
+// every heap allocation of the process goes through here
+static std::atomic<long long> allocations(0);
+static std::atomic<long long> allocatedBytes(0);
+
+void* operator new(size_t size)
+{
+    allocations++;
+    allocatedBytes += size;
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+// what the view would do with the callbacks, without the sprites
+class CountingDelegate : public World::Delegate
+{
+public:
+    CountingDelegate() : added(0), coins(0) {}
+
+    virtual void onObjectAdded(int index) override { added++; }
+    virtual void onCoinCollected() override { coins++; }
+
+    long long added;
+    long long coins;
+    int capped;                         // runs stopped by --seconds instead of game over
+};
+
+struct Results
+{
+    long long steps;
+    long long score;
+    long long objects;
+    long long coins;
+    int capped;                         // runs stopped by --seconds instead of game over
+};
+
+static void play(World& world, int runs, int maxSteps, Results& results)
+{
+    CountingDelegate delegate;
+    world.setDelegate(&delegate);
+
+    Bot bot;
+    results = {0, 0, 0, 0, 0};
+    for (int run=0; run<runs; run++)
+    {
+        world.setSeed(run + 1);
+        world.reset();
+        while (world.getActorMode() != World::GAMEOVER && world.getStepCount() < maxSteps)
+        {
+            world.setButtonPressed(bot.update(world));
+            world.step();
+        }
+        if (world.getActorMode() != World::GAMEOVER)
+            results.capped++;
+        results.steps += world.getStepCount();
+        results.score += world.getScore();
+    }
+    results.objects = delegate.added;
+    results.coins = delegate.coins;
+
+    world.setDelegate(nullptr);
+}
+
+int main(int argc, char** argv)
+{
+    int runs = 1000;
+    float seconds = 120;
+    std::string packPath;
+    double minFps = 0;
+    double maxAllocs = -1;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "--runs") == 0 && i+1 < argc)
+            runs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seconds") == 0 && i+1 < argc)
+            seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--pack") == 0 && i+1 < argc)
+            packPath = argv[++i];
+        else if (strcmp(argv[i], "--min-fps") == 0 && i+1 < argc)
+            minFps = atof(argv[++i]);
+        else if (strcmp(argv[i], "--max-allocs") == 0 && i+1 < argc)
+            maxAllocs = atof(argv[++i]);
+        else
+        {
+            runs = 0;
+            break;
+        }
+    }
+
+    // the negated test rejects NaN too
+    if (runs < 1 || !(seconds > 0))
+    {
+        fprintf(stderr, "usage: game_benchmark [--runs N] [--seconds S] [--pack maps.pkm] [--min-fps F] [--max-allocs A]\n"
+                        "  N runs (at least 1), each until game over. S caps a run at S simulated\n"
+                        "  seconds (more than 0, 120 by default): it doesn't set its length\n");
+        return 1;
+    }
+
+    MapPack pack;
+    World world;
+    if (!packPath.empty())
+    {
+        if (!pack.initWithFile(packPath))
+        {
+            fprintf(stderr, "game_benchmark: %s is not a valid map pack\n", packPath.c_str());
+            return 1;
+        }
+        world.setMapPack(&pack);
+    }
+
+    // at least one step, so the frame rates are defined
+    double steps = seconds / World::FIXED_DT;
+    int maxSteps = steps < 1 ? 1 : steps > INT_MAX ? INT_MAX : (int)steps;
+
+    // warm up: the containers of the world grow to their working size
+    Results results;
+    play(world, 10, maxSteps, results);
+
+    long long allocationsBefore = allocations;
+    long long bytesBefore = allocatedBytes;
+    auto start = std::chrono::steady_clock::now();
+
+    play(world, runs, maxSteps, results);
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double fps = results.steps / elapsed.count();
+    double allocsPerFrame = (double)(allocations - allocationsBefore) / results.steps;
+    double bytesPerFrame = (double)(allocatedBytes - bytesBefore) / results.steps;
+
+    printf("runs:                 %d, until game over (capped at %g s: %d runs)\n", runs, seconds, results.capped);
+    printf("simulated:            %lld frames, %.1f s\n", results.steps, results.steps * World::FIXED_DT);
+    printf("average run:          %.1f s, score %.0f\n", results.steps * World::FIXED_DT / runs, (double)results.score / runs);
+    printf("objects spawned:      %lld, coins collected %lld\n", results.objects, results.coins);
+    printf("wall time:            %.3f s\n", elapsed.count());
+    printf("simulated frames/s:   %.0f (%.0fx real time)\n", fps, fps * World::FIXED_DT);
+    printf("allocations/frame:    %.4f (%.2f bytes)\n", allocsPerFrame, bytesPerFrame);
+
+    bool ok = true;
+    if (fps < minFps)
+    {
+        fprintf(stderr, "game_benchmark: %.0f frames/s is below %.0f\n", fps, minFps);
+        ok = false;
+    }
+    if (maxAllocs >= 0 && allocsPerFrame > maxAllocs)
+    {
+        fprintf(stderr, "game_benchmark: %.4f allocations/frame is above %.4f\n", allocsPerFrame, maxAllocs);
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
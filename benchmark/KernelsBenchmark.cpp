@@ -0,0 +1,158 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Scroll and AABB test cost per object: the per-Sprite path that
+// GameNode used to have vs the scalar and the SIMD ObjectKernels.
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "ObjectKernels.h"
+#include "World.h"
+
+// What the old path did for each object: a virtual setPosition() that
+// dirties the transform, and a getBoundingBox() that recomputes the
+// node-to-parent transform and applies it to the 4 corners of the content
+class FakeSprite
+{
+public:
+    FakeSprite(float x, float y, float width, float height)
+    : _x(x), _y(y), _width(width), _height(height), _transformDirty(true)
+    {
+    }
+    virtual ~FakeSprite() {}
+
+    virtual void setPosition(float x, float y)
+    {
+        _x = x;
+        _y = y;
+        _transformDirty = true;
+    }
+    float getPositionX() const { return _x; }
+    float getPositionY() const { return _y; }
+
+    World::Rect getBoundingBox()
+    {
+        if (_transformDirty)
+        {
+            // scale 1, no rotation, no skew, anchor point at (0,0)
+            _transform[0] = 1; _transform[1] = 0;
+            _transform[2] = 0; _transform[3] = 1;
+            _transform[4] = _x; _transform[5] = _y;
+            _transformDirty = false;
+        }
+
+        float xs[4] = {0, _width, 0, _width};
+        float ys[4] = {0, 0, _height, _height};
+        float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f;
+        for (int i=0; i<4; i++)
+        {
+            float tx = _transform[0] * xs[i] + _transform[2] * ys[i] + _transform[4];
+            float ty = _transform[1] * xs[i] + _transform[3] * ys[i] + _transform[5];
+            minX = std::min(minX, tx);
+            maxX = std::max(maxX, tx);
+            minY = std::min(minY, ty);
+            maxY = std::max(maxY, ty);
+        }
+        World::Rect rect = {minX, minY, maxX - minX, maxY - minY};
+        return rect;
+    }
+
+protected:
+    float _x, _y, _width, _height;
+    float _transform[6];
+    bool _transformDirty;
+};
+
+template <typename F>
+static double nanosPerObject(int count, F func)
+{
+    const int iterations = 20000000 / count + 100;
+    auto start = std::chrono::steady_clock::now();
+    for (int i=0; i<iterations; i++)
+        func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations / count;
+}
+
+int main(int argc, char** argv)
+{
+    const int counts[] = {10, 100, 10000};
+    const World::Rect actorBB = {60, 60, 12, 56};
+
+    printf("kernels: %s\n", getObjectKernelsName());
+    printf("%8s %6s %14s %14s %14s\n", "objects", "", "sprite (ns)", "scalar (ns)", "simd (ns)");
+
+    for (int count: counts)
+    {
+        std::vector<std::unique_ptr<FakeSprite>> sprites;
+        ObjectStore objects;
+        for (int i=0; i<count; i++)
+        {
+            float x = 60 + (i - count/2) * 28.0f;
+            float y = 60 + (i % 5) * 44.0f;
+            sprites.push_back(std::unique_ptr<FakeSprite>(new FakeSprite(x, y, 56, 44)));
+            objects.push(World::BOX, x, y, 56, 44, i, 0);
+        }
+        std::vector<unsigned char> mask(count);
+        volatile float sinkf = 0;
+        volatile int sink = 0;
+
+        // scroll by 0 so the objects stay in place between iterations
+        double spriteScroll = nanosPerObject(count, [&]() {
+            for (auto& sprite: sprites)
+                sprite->setPosition(sprite->getPositionX() - 0.0f, sprite->getPositionY());
+            sinkf += sprites[0]->getPositionX();
+        });
+        double scalarScroll = nanosPerObject(count, [&]() {
+            scrollObjectsScalar(objects.x.data(), count, 0.0f);
+            sinkf += objects.x[0];
+        });
+        double simdScroll = nanosPerObject(count, [&]() {
+            scrollObjects(objects.x.data(), count, 0.0f);
+            sinkf += objects.x[0];
+        });
+        printf("%8d %6s %14.2f %14.2f %14.2f\n", count, "scroll", spriteScroll, scalarScroll, simdScroll);
+
+        double spriteAABB = nanosPerObject(count, [&]() {
+            int hits = 0;
+            for (auto& sprite: sprites)
+                hits += actorBB.intersects(sprite->getBoundingBox());
+            sink += hits;
+        });
+        double scalarAABB = nanosPerObject(count, [&]() {
+            sink += intersectObjectsScalar(objects.x.data(), objects.y.data(), objects.width.data(), objects.height.data(), count,
+                                           actorBB.x, actorBB.y, actorBB.width, actorBB.height, mask.data());
+        });
+        double simdAABB = nanosPerObject(count, [&]() {
+            sink += intersectObjects(objects.x.data(), objects.y.data(), objects.width.data(), objects.height.data(), count,
+                                     actorBB.x, actorBB.y, actorBB.width, actorBB.height, mask.data());
+        });
+        printf("%8d %6s %14.2f %14.2f %14.2f\n", count, "aabb", spriteAABB, scalarAABB, simdAABB);
+    }
+    return 0;
+}
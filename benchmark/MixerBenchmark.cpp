@@ -0,0 +1,290 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Software mixer without a sound device.
+// 1. throughput: all the voices busy, mixed as fast as possible
+// 2. game: the effects of bot runs mixed frame by frame, written to a
+//    .wav file only with --out
+// 3. real time: a game thread posts the effects through AudioDispatcher
+//    at 60 fps while a device thread mixes blocks at the sample rate.
+//    Reports the latency from the effect to the mix that starts it
+//
+//   mixer_benchmark [--seconds S] [--out mix.wav] [--realtime S]
+//                   [--jump a.wav] [--coin b.wav] [--crouch c.wav]
+//
+// The effects are synthesized unless .wav files (16 bits PCM) are given:
+// the mp3 files of the game can't be decoded here.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AudioDispatcher.h"
+#include "Bot.h"
+#include "Mixer.h"
+#include "Wav.h"
+#include "World.h"
+
+enum Effect {
+    JUMP,
+    PICKUP_COIN,
+    CROUCH,
+    EFFECTS
+};
+
+static const int SAMPLE_RATE = 44100;
+
+typedef std::chrono::steady_clock Clock;
+
+// a tone sweeping from 'from' to 'to' Hz, with a linear fade out
+static std::vector<int16_t> synthesize(float seconds, float from, float to, float noise)
+{
+    int frames = (int)(seconds * SAMPLE_RATE);
+    std::vector<int16_t> samples(frames);
+    double phase = 0;
+    unsigned int random = 1;
+    for (int i=0; i<frames; i++)
+    {
+        float t = (float)i / frames;
+        phase += 2 * M_PI * (from + (to - from) * t) / SAMPLE_RATE;
+        random = random * 1664525 + 1013904223;
+        float value = (float)sin(phase) * (1 - noise) + ((random >> 16) / 32768.0f - 1) * noise;
+        samples[i] = (int16_t)(value * (1 - t) * 12000);
+    }
+    return samples;
+}
+
+static bool addSound(Mixer& mixer, const std::string& path, const std::vector<int16_t>& fallback)
+{
+    if (path.empty())
+        return mixer.addSound(fallback.data(), (int)fallback.size(), 1, SAMPLE_RATE) >= 0;
+
+    std::vector<int16_t> samples;
+    int channels, sampleRate;
+    if (!loadWav(path, samples, channels, sampleRate))
+    {
+        fprintf(stderr, "mixer_benchmark: %s is not a 16 bits PCM .wav file\n", path.c_str());
+        return false;
+    }
+    if (mixer.addSound(samples.data(), (int)samples.size() / channels, channels, sampleRate) < 0)
+    {
+        fprintf(stderr, "mixer_benchmark: %s can't be mixed\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// jump, pickup_coin and crouch
+static bool addSounds(Mixer& mixer, const std::string paths[EFFECTS])
+{
+    return addSound(mixer, paths[JUMP], synthesize(0.3f, 300, 900, 0)) &&
+           addSound(mixer, paths[PICKUP_COIN], synthesize(0.15f, 1300, 2100, 0)) &&
+           addSound(mixer, paths[CROUCH], synthesize(0.2f, 120, 80, 0.6f));
+}
+
+// the effects GameNode plays
+class EffectsDelegate : public World::Delegate
+{
+public:
+    virtual void onActorModeChanged(World::ActorMode mode) override
+    {
+        if (mode == World::JUMPING_UP)
+            frame.push_back(JUMP);
+        else if (mode == World::CROUCH)
+            frame.push_back(CROUCH);
+    }
+    virtual void onCoinCollected() override { frame.push_back(PICKUP_COIN); }
+
+    std::vector<int> frame;
+};
+
+// the effects of every frame of bot runs at 60 fps
+static std::vector<std::vector<int>> recordEffects(int frames)
+{
+    std::vector<std::vector<int>> effects;
+    EffectsDelegate delegate;
+    World world;
+    world.setDelegate(&delegate);
+    Bot bot;
+    for (int run=0; (int)effects.size() < frames; run++)
+    {
+        world.setSeed(run + 1);
+        world.reset();
+        while (world.getActorMode() != World::GAMEOVER && (int)effects.size() < frames)
+        {
+            delegate.frame.clear();
+            world.setButtonPressed(bot.update(world));
+            world.advance(1 / 60.0f);
+            effects.push_back(delegate.frame);
+        }
+    }
+    return effects;
+}
+
+int main(int argc, char** argv)
+{
+    float seconds = 600;
+    float realtimeSeconds = 3;
+    std::string outPath;
+    std::string soundPaths[EFFECTS];
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "--seconds") == 0 && i+1 < argc)
+            seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--realtime") == 0 && i+1 < argc)
+            realtimeSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--out") == 0 && i+1 < argc)
+            outPath = argv[++i];
+        else if (strcmp(argv[i], "--jump") == 0 && i+1 < argc)
+            soundPaths[JUMP] = argv[++i];
+        else if (strcmp(argv[i], "--coin") == 0 && i+1 < argc)
+            soundPaths[PICKUP_COIN] = argv[++i];
+        else if (strcmp(argv[i], "--crouch") == 0 && i+1 < argc)
+            soundPaths[CROUCH] = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: mixer_benchmark [--seconds S] [--out mix.wav] [--realtime S] [--jump a.wav] [--coin b.wav] [--crouch c.wav]\n");
+            return 1;
+        }
+    }
+
+    // 1. throughput
+    {
+        Mixer mixer(SAMPLE_RATE);
+        if (!addSounds(mixer, soundPaths))
+            return 1;
+
+        std::vector<int16_t> out(Mixer::BLOCK_FRAMES);
+        long long frames = (long long)(seconds * SAMPLE_RATE);
+        long long voiceFrames = 0;
+        auto start = Clock::now();
+        for (long long done=0; done<frames; done+=Mixer::BLOCK_FRAMES)
+        {
+            // keep every voice busy
+            for (int voice=mixer.getActiveVoices(); voice<Mixer::MAX_VOICES; voice++)
+                mixer.play(voice % EFFECTS, 0.1f);
+            voiceFrames += (long long)mixer.getActiveVoices() * Mixer::BLOCK_FRAMES;
+            mixer.mix(out.data(), Mixer::BLOCK_FRAMES);
+        }
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+        printf("throughput: %.0f s of audio, %d voices, in %.3f s: %.0fx real time, %.2f ns per voice sample\n",
+               seconds, Mixer::MAX_VOICES, elapsed.count(), seconds / elapsed.count(),
+               elapsed.count() * 1e9 / voiceFrames);
+    }
+
+    // 2. bot runs, to a .wav file if asked
+    {
+        Mixer game(SAMPLE_RATE);
+        addSounds(game, soundPaths);
+
+        auto effects = recordEffects(60 * 60);
+        WavWriter wav;
+        if (!outPath.empty() && !wav.open(outPath, 1, SAMPLE_RATE))
+        {
+            fprintf(stderr, "mixer_benchmark: can't write %s\n", outPath.c_str());
+            return 1;
+        }
+        std::vector<int16_t> out(SAMPLE_RATE / 60 + 1);
+        long long mixed = 0;
+        for (int frame=0; frame<(int)effects.size(); frame++)
+        {
+            for (int effect : effects[frame])
+                game.play(effect);
+            // samples up to the end of this frame
+            long long end = (long long)(frame + 1) * SAMPLE_RATE / 60;
+            int count = (int)(end - mixed);
+            game.mix(out.data(), count);
+            if (!outPath.empty())
+                wav.write(out.data(), count);
+            mixed = end;
+        }
+        auto metrics = game.getMetrics();
+        printf("game: %d frames, %lld effects, max %d voices, %lld stolen\n",
+               (int)effects.size(), metrics.played, metrics.maxActiveVoices, metrics.stolen);
+        if (!outPath.empty())
+        {
+            if (!wav.close())
+            {
+                fprintf(stderr, "mixer_benchmark: can't write %s\n", outPath.c_str());
+                return 1;
+            }
+            printf("  written to %s\n", outPath.c_str());
+        }
+    }
+
+    // 3. real time: game thread -> AudioDispatcher -> Mixer <- device thread
+    if (realtimeSeconds > 0)
+    {
+        Mixer device(SAMPLE_RATE);
+        addSounds(device, soundPaths);
+
+        std::atomic<bool> quit(false);
+        std::thread deviceThread([&](){
+            // one block per block duration, like an audio callback
+            std::vector<int16_t> out(Mixer::BLOCK_FRAMES);
+            auto blockTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>((double)Mixer::BLOCK_FRAMES / SAMPLE_RATE));
+            auto next = Clock::now();
+            while (!quit)
+            {
+                device.mix(out.data(), Mixer::BLOCK_FRAMES);
+                next += blockTime;
+                std::this_thread::sleep_until(next);
+            }
+        });
+
+        int frames = (int)(realtimeSeconds * 60);
+        auto effects = recordEffects(frames);
+        AudioDispatcher::Metrics dispatched;
+        {
+            AudioDispatcher dispatcher([&](int effect){ device.play(effect); });
+            auto frameTime = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1 / 60.0));
+            auto next = Clock::now();
+            for (auto& frame : effects)
+            {
+                for (int effect : frame)
+                    dispatcher.post(effect);
+                dispatcher.flush();
+                next += frameTime;
+                std::this_thread::sleep_until(next);
+            }
+            dispatched = dispatcher.getMetrics();
+        }
+        quit = true;
+        deviceThread.join();
+
+        auto metrics = device.getMetrics();
+        printf("real time: %d frames, %lld effects. Block %d frames (%.1f ms)\n", frames, metrics.played,
+               Mixer::BLOCK_FRAMES, Mixer::BLOCK_FRAMES * 1000.0 / SAMPLE_RATE);
+        printf("  dispatch latency: average %.3f ms, max %.3f ms\n", dispatched.averageLatency * 1000, dispatched.maxLatency * 1000);
+        printf("  mixer latency:    average %.3f ms, max %.3f ms\n", metrics.averageLatency * 1000, metrics.maxLatency * 1000);
+    }
+    return 0;
+}
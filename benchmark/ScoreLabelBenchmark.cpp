@@ -0,0 +1,242 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Cost of updating the score label every frame, before and after
+// NumericLabel, without GL: the scores of bot runs are replayed through
+// - string: what GameNode::updateScore() did with Label: snprintf,
+//   Label::setString() (compare, copy, UTF-16 conversion) and a new
+//   quad for every glyph
+// - digits: NumericText, and a new quad only for the digits that changed
+// The quads are written to memory, like a label would before uploading
+// them. Reports the time and the heap allocations per frame.
+//
+//   score_label_benchmark [--runs N] [--repeat R]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "Bot.h"
+#include "NumericText.h"
+#include "World.h"
+
+// every heap allocation of the process goes through here
+static std::atomic<long long> allocations(0);
+
+void* operator new(size_t size)
+{
+    allocations++;
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+// font_grinched_21.plist of res-small
+static const int ITEM_WIDTH = 16;
+static const int ITEM_HEIGHT = 24;
+static const int FIRST_CHAR = '0';
+static const int ITEMS_PER_ROW = 256 / ITEM_WIDTH;
+static const float TEXTURE_WIDTH = 256;
+static const float TEXTURE_HEIGHT = 32;
+
+struct GlyphQuad
+{
+    float x0, y0, x1, y1;
+    float u0, v0, u1, v1;
+};
+
+static void writeGlyph(GlyphQuad& quad, int position, int c)
+{
+    int item = c - FIRST_CHAR;
+    float x = (float)((item % ITEMS_PER_ROW) * ITEM_WIDTH);
+    float y = (float)((item / ITEMS_PER_ROW) * ITEM_HEIGHT);
+    quad.x0 = (float)(position * ITEM_WIDTH);
+    quad.y0 = 0;
+    quad.x1 = quad.x0 + ITEM_WIDTH;
+    quad.y1 = ITEM_HEIGHT;
+    quad.u0 = x / TEXTURE_WIDTH;
+    quad.v0 = (y + ITEM_HEIGHT) / TEXTURE_HEIGHT;
+    quad.u1 = (x + ITEM_WIDTH) / TEXTURE_WIDTH;
+    quad.v1 = y / TEXTURE_HEIGHT;
+}
+
+// before
+class StringLabel
+{
+public:
+    StringLabel() : quadWrites(0) {}
+
+    void update(int score)
+    {
+        char buffer[40];
+        snprintf(buffer,sizeof(buffer)-1,"%d",score);
+        setString(buffer);
+    }
+
+    // like Label::setString() and Label::updateContent()
+    void setString(const std::string& text)
+    {
+        if (text.compare(_text) == 0)
+            return;
+        _text = text;
+
+        std::u16string utf16(_text.begin(), _text.end());
+        for (int i=0; i<(int)utf16.size(); i++)
+            writeGlyph(quads[i], i, utf16[i]);
+        quadWrites += utf16.size();
+    }
+
+    GlyphQuad quads[NumericText::MAX_SLOTS];
+    long long quadWrites;
+
+protected:
+    std::string _text;
+};
+
+// after
+class DigitsLabel
+{
+public:
+    explicit DigitsLabel(int slots) : text(slots), quadWrites(0) {}
+
+    void update(int score)
+    {
+        unsigned int changed = text.setValue(score);
+        for (int slot=0; changed; slot++, changed >>= 1)
+        {
+            if (changed & 1)
+            {
+                int digit = text.getDigit(slot);
+                if (digit == NumericText::BLANK)
+                    memset(&quads[slot], 0, sizeof(GlyphQuad));
+                else
+                    writeGlyph(quads[slot], slot, '0' + digit);
+                quadWrites++;
+            }
+        }
+    }
+
+    NumericText text;
+    GlyphQuad quads[NumericText::MAX_SLOTS];
+    long long quadWrites;
+};
+
+// the score of every frame of 'runs' bot runs, at 60 fps
+static std::vector<int> recordScores(int runs)
+{
+    std::vector<int> scores;
+    World world;
+    Bot bot;
+    for (int run=0; run<runs; run++)
+    {
+        world.setSeed(run + 1);
+        world.reset();
+        while (world.getActorMode() != World::GAMEOVER)
+        {
+            world.setButtonPressed(bot.update(world));
+            world.advance(1 / 60.0f);
+            scores.push_back(world.getScore());
+        }
+    }
+    return scores;
+}
+
+template <typename Label>
+static void replay(Label& label, const std::vector<int>& scores, int repeat, double& seconds, long long& allocs)
+{
+    long long allocationsBefore = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int r=0; r<repeat; r++)
+    {
+        for (int score : scores)
+            label.update(score);
+        // next pass starts from 0 again, like a new run
+        label.update(0);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    seconds = elapsed.count();
+    allocs = allocations - allocationsBefore;
+}
+
+static float checksum(const GlyphQuad* quads)
+{
+    float sum = 0;
+    for (int i=0; i<NumericText::MAX_SLOTS; i++)
+        sum += quads[i].x0 + quads[i].u0 + quads[i].v0;
+    return sum;
+}
+
+int main(int argc, char** argv)
+{
+    int runs = 100;
+    int repeat = 20;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "--runs") == 0 && i+1 < argc)
+            runs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--repeat") == 0 && i+1 < argc)
+            repeat = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: score_label_benchmark [--runs N] [--repeat R]\n");
+            return 1;
+        }
+    }
+
+    auto scores = recordScores(runs);
+    long long frames = (long long)(scores.size() + 1) * repeat;
+
+    // same number of slots as GameNode
+    StringLabel before;
+    DigitsLabel after(8);
+    before.update(0);
+    after.update(0);
+    before.quadWrites = after.quadWrites = 0;
+
+    double beforeSeconds, afterSeconds;
+    long long beforeAllocs, afterAllocs;
+    replay(before, scores, repeat, beforeSeconds, beforeAllocs);
+    replay(after, scores, repeat, afterSeconds, afterAllocs);
+
+    printf("%lld frames (%d runs x %d)\n", frames, runs, repeat);
+    printf("            ns/frame  quads/frame  allocations/frame\n");
+    printf("string:     %8.2f  %11.2f  %17.4f\n", beforeSeconds * 1e9 / frames,
+           (double)before.quadWrites / frames, (double)beforeAllocs / frames);
+    printf("digits:     %8.2f  %11.2f  %17.4f\n", afterSeconds * 1e9 / frames,
+           (double)after.quadWrites / frames, (double)afterAllocs / frames);
+    printf("(checksum %.1f %.1f)\n", checksum(before.quads), checksum(after.quads));
+    return 0;
+}
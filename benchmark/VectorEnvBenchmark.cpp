@@ -0,0 +1,109 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Steps per second of VectorEnv: N environments in lockstep, with a
+// policy that only reads the observation buffer (the same rule as Bot).
+//
+//   vector_env_benchmark [--envs N] [--steps S] [--threads T]
+//
+// --threads 0 uses one thread per core. Without it everything runs
+// in the calling thread.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "TaskPool.h"
+#include "VectorEnv.h"
+
+// jumps when an obstacle higher than the actor's feet is close
+static void policy(const float* observations, int count, unsigned char* actions)
+{
+    for (int i=0; i<count; i++)
+    {
+        const float* obs = observations + i * VectorEnv::OBSERVATION_SIZE;
+        float feet = obs[0];
+        float reach = 50 + obs[2] * 0.2f;
+
+        const float* object = obs + VectorEnv::ACTOR_FEATURES;
+        bool press = false;
+        for (int j=0; j<VectorEnv::NEARBY_OBJECTS && !press; j++, object += VectorEnv::OBJECT_FEATURES)
+            press = object[5] && object[0] > 25 && object[0] < reach && object[1] + object[3] > feet + 1;
+        actions[i] = press;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int envs = 4096;
+    int steps = 1000;
+    int threads = -1;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "--envs") == 0 && i+1 < argc)
+            envs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--steps") == 0 && i+1 < argc)
+            steps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i+1 < argc)
+            threads = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: vector_env_benchmark [--envs N] [--steps S] [--threads T]\n");
+            return 1;
+        }
+    }
+
+    std::unique_ptr<TaskPool> pool;
+    if (threads >= 0)
+        pool.reset(new TaskPool(threads));
+
+    VectorEnv env(envs, nullptr, pool.get());
+    env.setMaxSteps(60 * 120);
+    env.reset(1);
+
+    std::vector<unsigned char> actions(envs);
+    double reward = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int step=0; step<steps; step++)
+    {
+        policy(env.getObservations(), envs, actions.data());
+        env.step(actions.data());
+
+        const float* rewards = env.getRewards();
+        for (int i=0; i<envs; i++)
+            reward += rewards[i];
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double total = (double)envs * steps;
+    printf("%d environments x %d steps, %d threads\n", envs, steps, pool ? pool->getThreadCount() : 1);
+    printf("%.0f steps/s, %lld episodes, mean reward per step %.4f\n",
+           total / elapsed.count(), env.getEpisodeCount(), reward / total);
+    return 0;
+}
@@ -14,7 +14,23 @@ LOCAL_SRC_FILES := game/main.cpp \
                    ../../Classes/AppDelegate.cpp \
                    ../../Classes/GameNode.cpp \
                    ../../Classes/MainMenuNode.cpp \
-                   ../../Classes/Map.cpp
+                   ../../Classes/Map.cpp \
+                   ../../Classes/World.cpp \
+                   ../../Classes/ObjectStore.cpp \
+                   ../../Classes/ObjectKernels.cpp \
+                   ../../Classes/MapPack.cpp \
+                   ../../Classes/Profiler.cpp \
+                   ../../Classes/Tracer.cpp \
+                   ../../Classes/InputJournal.cpp \
+                   ../../Classes/ObjectRenderer.cpp \
+                   ../../Classes/ParallaxLayers.cpp \
+                   ../../Classes/NumericText.cpp \
+                   ../../Classes/NumericLabel.cpp \
+                   ../../Classes/AudioDispatcher.cpp \
+                   ../../Classes/TaskPool.cpp \
+                   ../../Classes/ResourceLoader.cpp \
+                   ../../Classes/AnimationRegistry.cpp \
+                   ../../Classes/GameAudio.cpp
 
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/../../Classes
 
@@ -1,4 +1,5 @@
 #include "../Classes/AppDelegate.h"
+#include "../Classes/Tracer.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -11,5 +12,23 @@ int main(int argc, char **argv)
 {
     // create the application instance
     AppDelegate app;
+
+#ifdef PARKOUR_ENABLE_TRACER
+    // Application::run() owns the loop: each iteration is traced
+    // from the end of a draw to the end of the next one
+    auto tracer = Tracer::getInstance();
+    tracer->begin("mainLoop");
+    Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_DRAW, [tracer](EventCustom* event){
+        tracer->end("mainLoop");
+        tracer->begin("mainLoop");
+    });
+
+    int ret = Application::getInstance()->run();
+
+    tracer->end("mainLoop");
+    tracer->writeFile("trace.json");
+    return ret;
+#else
     return Application::getInstance()->run();
+#endif
 }
@@ -18,6 +18,7 @@
 
 #include "Cocos2dRenderer.h"
 #include "AppDelegate.h"
+#include "Tracer.h"
 #include "CCGLViewImpl-winrt.h"
 #include "CCApplication.h"
 #include "cocos2d.h"
@@ -112,6 +113,8 @@ void Cocos2dRenderer::DeviceLost()
 
 void Cocos2dRenderer::Draw(GLsizei width, GLsizei height, float dpi, DisplayOrientations orientation)
 {
+    PARKOUR_TRACE("Cocos2dRenderer::Draw");
+
     auto glView = GLViewImpl::sharedOpenGLView();
 
     if (orientation != m_orientation)
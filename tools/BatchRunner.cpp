@@ -0,0 +1,277 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Plays thousands of independent seeded runs in parallel and reports,
+// per map, how often it kills the player and how many coins it gives.
+// Useful to tune the maps and the physics constants of World.cpp
+// without playing them by hand.
+//
+// The runs are played by Bot, a fixed scripted policy that holds the
+// button when an obstacle is close. The stats tell how that policy
+// fares, not how hard a map is for a player: some built-in maps always
+// kill it.
+//
+//   batch_runner [--runs N] [--seconds S] [--seed S] [--threads T]
+//                [--pack maps.pkm] [--csv maps.csv]
+//
+// Every run is one task of a work-stealing pool, with its own World and
+// Bot: nothing is shared in between runs. Run 'i' uses seed S + i, so the
+// results don't depend on the number of threads.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "Bot.h"
+#include "MapPack.h"
+#include "TaskPool.h"
+#include "World.h"
+
+struct RunResult
+{
+    int steps;
+    int score;                          // distance, in pixels
+    int coins;
+    bool died;                          // false if it reached the time limit
+    World::Death death;
+    std::vector<int> mapsQueued;        // per map
+    std::vector<int> mapCoins;          // per map
+};
+
+// collects the per map stats of a run
+class RunRecorder : public World::Delegate
+{
+public:
+    RunRecorder(const World& world, RunResult& result) : _world(world), _result(result) {}
+
+    virtual void onMapQueued(int map) override
+    {
+        _result.mapsQueued[map]++;
+    }
+
+    virtual void onObjectKilled(int index) override
+    {
+        // only coins are killed
+        _result.mapCoins[_world.getObjects().map[index]]++;
+        _result.coins++;
+    }
+
+protected:
+    const World& _world;
+    RunResult& _result;
+};
+
+struct MapStats
+{
+    long long queued;
+    long long coins;
+    int deaths;
+    int deathsByType[World::OBJECT_TYPES];
+    int deathsByMode[World::GAMEOVER];
+    double distance;                    // sum of the distances of the runs that died here
+};
+
+static const char* MODE_NAMES[World::GAMEOVER] = {"running", "jumping up", "jumping down", "crouch"};
+
+static float percentile(std::vector<int>& values, int percent)
+{
+    std::sort(values.begin(), values.end());
+    return values[(values.size() - 1) * percent / 100];
+}
+
+int main(int argc, char** argv)
+{
+    int runs = 10000;
+    float seconds = 120;
+    unsigned int seed = 1;
+    int threads = 0;
+    std::string packPath;
+    std::string csvPath;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "--runs") == 0 && i+1 < argc)
+            runs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seconds") == 0 && i+1 < argc)
+            seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i+1 < argc)
+            seed = (unsigned int)strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--threads") == 0 && i+1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--pack") == 0 && i+1 < argc)
+            packPath = argv[++i];
+        else if (strcmp(argv[i], "--csv") == 0 && i+1 < argc)
+            csvPath = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: batch_runner [--runs N] [--seconds S] [--seed S] [--threads T] [--pack maps.pkm] [--csv maps.csv]\n");
+            return 1;
+        }
+    }
+
+    if (runs < 1)
+    {
+        fprintf(stderr, "batch_runner: --runs must be at least 1\n");
+        return 1;
+    }
+
+    // read only once loaded: shared by all the runs
+    MapPack pack;
+    if (!packPath.empty() && !pack.initWithFile(packPath))
+    {
+        fprintf(stderr, "batch_runner: %s is not a valid map pack\n", packPath.c_str());
+        return 1;
+    }
+
+    int mapCount;
+    {
+        World world;
+        if (!packPath.empty())
+            world.setMapPack(&pack);
+        mapCount = world.getMapCount();
+    }
+    int maxSteps = (int)(seconds / World::FIXED_DT);
+
+    std::vector<RunResult> results(runs);
+    TaskPool pool(threads);
+
+    auto start = std::chrono::steady_clock::now();
+    pool.parallelFor(runs, [&](int run) {
+        RunResult& result = results[run];
+        result.coins = 0;
+        result.mapsQueued.assign(mapCount, 0);
+        result.mapCoins.assign(mapCount, 0);
+
+        World world;
+        if (!packPath.empty())
+            world.setMapPack(&pack);
+        RunRecorder recorder(world, result);
+        world.setDelegate(&recorder);
+
+        Bot bot;
+        world.setSeed(seed + run);
+        world.reset();
+        while (world.getActorMode() != World::GAMEOVER && world.getStepCount() < maxSteps)
+        {
+            world.setButtonPressed(bot.update(world));
+            world.step();
+        }
+
+        result.steps = world.getStepCount();
+        result.score = world.getScore();
+        result.died = world.getActorMode() == World::GAMEOVER;
+        result.death = world.getDeath();
+    }, 16);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    // aggregate, in run order
+    std::vector<MapStats> maps(mapCount, MapStats());
+    std::vector<int> distances;
+    std::vector<int> coins;
+    long long steps = 0;
+    int survivors = 0;
+    for (auto& result : results)
+    {
+        steps += result.steps;
+        distances.push_back(result.score);
+        coins.push_back(result.coins);
+        for (int i=0; i<mapCount; i++)
+        {
+            maps[i].queued += result.mapsQueued[i];
+            maps[i].coins += result.mapCoins[i];
+        }
+
+        if (!result.died)
+        {
+            survivors++;
+            continue;
+        }
+        MapStats& stats = maps[result.death.map];
+        stats.deaths++;
+        stats.deathsByType[result.death.type]++;
+        stats.deathsByMode[result.death.actorMode]++;
+        stats.distance += result.score;
+    }
+
+    printf("the runs are played by a fixed scripted policy (Bot): the rates below are\n"
+           "how it fares on each map, not how hard the maps are for a player\n");
+    printf("%d runs, %lld steps in %.2f s with %d threads (%.0f steps/s)\n",
+           runs, steps, elapsed.count(), pool.getThreadCount(), steps / elapsed.count());
+    printf("survived %.0f s: %d runs\n", seconds, survivors);
+    printf("distance: mean %.0f, p50 %.0f, p90 %.0f, max %.0f\n",
+           (double)std::accumulate(distances.begin(), distances.end(), 0LL) / runs,
+           percentile(distances, 50), percentile(distances, 90), percentile(distances, 100));
+    printf("coins:    mean %.1f, p50 %.0f, p90 %.0f, max %.0f\n\n",
+           (double)std::accumulate(coins.begin(), coins.end(), 0LL) / runs,
+           percentile(coins, 50), percentile(coins, 90), percentile(coins, 100));
+
+    printf("%4s %8s %8s %10s %10s %8s %8s", "map", "queued", "deaths", "deaths/q", "coins/q", "box", "anvil");
+    for (int mode=0; mode<World::GAMEOVER; mode++)
+        printf(" %13s", MODE_NAMES[mode]);
+    printf(" %14s\n", "mean distance");
+
+    FILE* csv = nullptr;
+    if (!csvPath.empty())
+    {
+        csv = fopen(csvPath.c_str(), "w");
+        if (!csv)
+        {
+            fprintf(stderr, "batch_runner: can't write %s\n", csvPath.c_str());
+            return 1;
+        }
+        fprintf(csv, "map,queued,deaths,deaths_per_queue,coins_per_queue,box,anvil,running,jumping_up,jumping_down,crouch,mean_distance\n");
+    }
+
+    for (int i=0; i<mapCount; i++)
+    {
+        const MapStats& stats = maps[i];
+        double deathRate = stats.queued ? (double)stats.deaths / stats.queued : 0;
+        double coinRate = stats.queued ? (double)stats.coins / stats.queued : 0;
+        double distance = stats.deaths ? stats.distance / stats.deaths : 0;
+
+        printf("%4d %8lld %8d %10.3f %10.2f %8d %8d", i, stats.queued, stats.deaths, deathRate, coinRate,
+               stats.deathsByType[World::BOX], stats.deathsByType[World::ANVIL]);
+        for (int mode=0; mode<World::GAMEOVER; mode++)
+            printf(" %13d", stats.deathsByMode[mode]);
+        printf(" %14.0f\n", distance);
+
+        if (csv)
+        {
+            fprintf(csv, "%d,%lld,%d,%.4f,%.4f,%d,%d", i, stats.queued, stats.deaths, deathRate, coinRate,
+                    stats.deathsByType[World::BOX], stats.deathsByType[World::ANVIL]);
+            for (int mode=0; mode<World::GAMEOVER; mode++)
+                fprintf(csv, ",%d", stats.deathsByMode[mode]);
+            fprintf(csv, ",%.1f\n", distance);
+        }
+    }
+
+    if (csv)
+        fclose(csv);
+    return 0;
+}
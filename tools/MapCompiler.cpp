@@ -0,0 +1,364 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Offline map compiler: turns map grids into a MapPack binary file.
+//
+//   map_compiler [--builtin] [maps.txt ...] -o maps.pkm
+//   map_compiler --dump maps.pkm
+//   map_compiler --verify [--pack maps.pkm] [maps.txt ...]
+//
+// --builtin adds the maps of Classes/Map.cpp, starting with the Get Ready one.
+// Without it, the first map of the first text file is the Get Ready map.
+//
+// Text files use the same grids as Classes/Map.cpp:
+//
+//   # comment
+//   map 28 44                          <- item width and height
+//   ...Bb................Bb.........
+//   ..BbBb......C.C.C..BbBbBb.....Bb
+//
+// --verify spawns the built-in maps through World and checks that the
+// objects are exactly the ones the old grid scan of World::addMap()
+// spawned. With --pack it does the same with the maps of the pack, which
+// must be the built-in maps followed by the ones of the text files, in
+// order. Exits with 1 on the first mismatch.
+//
+// Regenerate Resources/maps/maps.pkm with:
+//   map_compiler --builtin -o Resources/maps/maps.pkm
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Map.h"
+#include "MapPack.h"
+#include "World.h"
+
+// a map parsed from a text file. It owns the rows
+struct TextMap
+{
+    std::vector<std::string> rows;
+    std::vector<const char*> buffer;
+    Map map;
+};
+
+static bool parseTextMaps(const std::string& path, std::vector<std::unique_ptr<TextMap>>& textMaps)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        fprintf(stderr, "map_compiler: can't open %s\n", path.c_str());
+        return false;
+    }
+
+    TextMap* current = nullptr;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '#')
+        {
+            current = nullptr;
+            continue;
+        }
+
+        float itemWidth, itemHeight;
+        if (sscanf(line.c_str(), "map %f %f", &itemWidth, &itemHeight) == 2)
+        {
+            // the negated test rejects NaN too, like MapPack does
+            if (!(itemWidth > 0) || !(itemHeight > 0))
+            {
+                fprintf(stderr, "%s:%d: the item width and height must be positive\n", path.c_str(), lineNumber);
+                return false;
+            }
+            textMaps.push_back(std::unique_ptr<TextMap>(new TextMap));
+            current = textMaps.back().get();
+            current->map.item_size = {itemWidth, itemHeight};
+            continue;
+        }
+
+        if (!current)
+        {
+            fprintf(stderr, "%s:%d: grid row outside of a map\n", path.c_str(), lineNumber);
+            return false;
+        }
+        if (!current->rows.empty() && current->rows[0].size() != line.size())
+        {
+            fprintf(stderr, "%s:%d: all the rows of a map must have the same width\n", path.c_str(), lineNumber);
+            return false;
+        }
+        if (line.size() > MapPack::MAX_COLUMNS || current->rows.size() >= MapPack::MAX_ROWS)
+        {
+            fprintf(stderr, "%s:%d: a map has at most %u columns and %u rows\n", path.c_str(), lineNumber,
+                    MapPack::MAX_COLUMNS, MapPack::MAX_ROWS);
+            return false;
+        }
+        current->rows.push_back(line);
+    }
+
+    for (auto& textMap: textMaps)
+    {
+        textMap->buffer.clear();
+        for (auto& row: textMap->rows)
+            textMap->buffer.push_back(row.c_str());
+        textMap->map.buffer = textMap->buffer.data();
+        textMap->map.buffer_size = {
+            textMap->rows.empty() ? 0.0f : (float)textMap->rows[0].size(),
+            (float)textMap->rows.size()
+        };
+    }
+    return true;
+}
+
+static int dump(const std::string& path)
+{
+    MapPack pack;
+    if (!pack.initWithFile(path))
+    {
+        fprintf(stderr, "map_compiler: %s is not a valid map pack\n", path.c_str());
+        return 1;
+    }
+
+    for (int i=0; i<pack.getMapCount(); i++)
+    {
+        auto map = pack.getMap(i);
+        printf("map %d: %gx%g cells of %gx%g, %d entities\n", i,
+               map.buffer_size.width, map.buffer_size.height,
+               map.item_size.width, map.item_size.height, map.entityCount);
+    }
+    return 0;
+}
+
+// spawns one map at a time with World's streaming spawner: the same
+// queueMap() and addObjects() that run every step
+class SpawnProbe : public World
+{
+public:
+    const ObjectStore& spawn(int map, const MapSize& buffer_size, const MapSize& item_size)
+    {
+        // the screen is as wide as the map: every object of the map is
+        // inside the look-ahead window, the next map is not
+        Config config = getConfig();
+        config.screenWidth = buffer_size.width * item_size.width;
+        setConfig(config);
+
+        removeObjects(_objects.size());
+        queueMap(map, 0);
+        while (_chunkNext < _chunk.entityCount)
+            addObjects(0);
+        return _objects;
+    }
+};
+
+struct ReferenceObject
+{
+    int type;
+    float x;
+    float y;
+    float width;
+    float height;
+    int column;
+    int row;
+};
+
+// the grid scan World::addMap() had before the maps were compiled:
+// C, B and A cells spawn coins, boxes and anvils, column by column and
+// from the top row down. Scanned row by row and then ordered by column,
+// so it shares no code with compileMap(). X is relative to the map start
+static std::vector<ReferenceObject> referenceSpawn(const Map* map, const World::Config& config, float actorY)
+{
+    std::vector<ReferenceObject> objects;
+    int columns = (int)map->buffer_size.width;
+    int rows = (int)map->buffer_size.height;
+    for (int y=0; y<rows; y++)
+    {
+        for (int x=0; x<columns; x++)
+        {
+            int type;
+            switch (map->buffer[y][x])
+            {
+                case 'C': type = World::COIN; break;
+                case 'B': type = World::BOX; break;
+                case 'A': type = World::ANVIL; break;
+                default: continue;
+            }
+            int row = rows - y - 1;
+            objects.push_back({type, x * map->item_size.width, actorY + row * map->item_size.height,
+                               config.objectSize[type].width, config.objectSize[type].height, x, row});
+        }
+    }
+    std::stable_sort(objects.begin(), objects.end(), [](const ReferenceObject& a, const ReferenceObject& b) {
+        return a.column < b.column;
+    });
+    return objects;
+}
+
+static bool sameObjects(const char* name, int mapIndex, const std::vector<ReferenceObject>& expected, const ObjectStore& objects)
+{
+    if ((int)expected.size() != objects.size())
+    {
+        fprintf(stderr, "map_compiler: %s: World spawns %d objects, the grid scan %d\n", name, objects.size(), (int)expected.size());
+        return false;
+    }
+    for (int i=0; i<objects.size(); i++)
+    {
+        const ReferenceObject& e = expected[i];
+        if (objects.type[i] != e.type || objects.x[i] != e.x || objects.y[i] != e.y ||
+            objects.width[i] != e.width || objects.height[i] != e.height ||
+            objects.column[i] != e.column || objects.row[i] != e.row ||
+            objects.map[i] != mapIndex || !objects.alive[i])
+        {
+            fprintf(stderr, "map_compiler: %s: object %d is type %d at (%g,%g) from cell (%d,%d), "
+                            "the grid scan spawns type %d at (%g,%g) from cell (%d,%d)\n",
+                    name, i, objects.type[i], objects.x[i], objects.y[i], objects.column[i], objects.row[i],
+                    e.type, e.x, e.y, e.column, e.row);
+            return false;
+        }
+    }
+    return true;
+}
+
+static int verify(const std::vector<const Map*>& maps, const std::string& packPath, int builtinCount)
+{
+    // World only spawns the built-in maps and the ones of a pack
+    if (packPath.empty() && (int)maps.size() > builtinCount)
+    {
+        fprintf(stderr, "map_compiler: the text maps are checked in the pack compiled from them: add --pack\n");
+        return 1;
+    }
+
+    char name[32];
+    SpawnProbe world;
+    float actorY = world.getActorPosition().y;
+    for (int i=0; i<builtinCount; i++)
+    {
+        snprintf(name, sizeof(name), "map %d", i);
+        auto expected = referenceSpawn(maps[i], world.getConfig(), actorY);
+        auto& objects = world.spawn(i, maps[i]->buffer_size, maps[i]->item_size);
+        if (!sameObjects(name, i, expected, objects))
+            return 1;
+    }
+    printf("%d built-in maps: World spawns the same objects as the grid scan\n", builtinCount);
+
+    if (packPath.empty())
+        return 0;
+
+    MapPack pack;
+    if (!pack.initWithFile(packPath))
+    {
+        fprintf(stderr, "map_compiler: %s is not a valid map pack\n", packPath.c_str());
+        return 1;
+    }
+    if (pack.getMapCount() != (int)maps.size())
+    {
+        fprintf(stderr, "map_compiler: %s has %d maps, expected %d\n", packPath.c_str(), pack.getMapCount(), (int)maps.size());
+        return 1;
+    }
+    world.setMapPack(&pack);
+    for (int i=0; i<pack.getMapCount(); i++)
+    {
+        snprintf(name, sizeof(name), "pack map %d", i);
+        auto expected = referenceSpawn(maps[i], world.getConfig(), actorY);
+        auto compiled = pack.getMap(i);
+        auto& objects = world.spawn(i, compiled.buffer_size, compiled.item_size);
+        if (!sameObjects(name, i, expected, objects))
+            return 1;
+    }
+    printf("%s: World spawns the same objects as the grid scan of its %d maps\n", packPath.c_str(), pack.getMapCount());
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    bool builtin = false;
+    bool verifying = false;
+    std::string packPath;
+    std::string output;
+    std::vector<std::string> inputs;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "--builtin") == 0)
+            builtin = true;
+        else if (strcmp(argv[i], "--dump") == 0 && i+1 < argc)
+            return dump(argv[++i]);
+        else if (strcmp(argv[i], "--verify") == 0)
+            verifying = true;
+        else if (strcmp(argv[i], "--pack") == 0 && i+1 < argc)
+            packPath = argv[++i];
+        else if (strcmp(argv[i], "-o") == 0 && i+1 < argc)
+            output = argv[++i];
+        else
+            inputs.push_back(argv[i]);
+    }
+
+    if (!verifying && (output.empty() || (!builtin && inputs.empty())))
+    {
+        fprintf(stderr, "usage: map_compiler [--builtin] [maps.txt ...] -o maps.pkm\n"
+                        "       map_compiler --dump maps.pkm\n"
+                        "       map_compiler --verify [--pack maps.pkm] [maps.txt ...]\n");
+        return 1;
+    }
+
+    std::vector<const Map*> maps;
+    if (builtin || verifying)
+    {
+        maps.push_back(getGetReadyMap());
+        for (int i=0; i<getMapCount(); i++)
+            maps.push_back(getMap(i));
+    }
+
+    std::vector<std::unique_ptr<TextMap>> textMaps;
+    for (auto& input: inputs)
+    {
+        if (!parseTextMaps(input, textMaps))
+            return 1;
+    }
+    int builtinCount = (int)maps.size();
+    for (auto& textMap: textMaps)
+        maps.push_back(&textMap->map);
+
+    if (verifying)
+        return verify(maps, packPath, builtinCount);
+
+    if (maps.empty() || maps.size() > MapPack::MAX_MAPS)
+    {
+        fprintf(stderr, "map_compiler: a pack holds 1 to %u maps, not %d\n", MapPack::MAX_MAPS, (int)maps.size());
+        return 1;
+    }
+
+    if (!MapPack::writeFile(output, maps))
+    {
+        fprintf(stderr, "map_compiler: can't write %s\n", output.c_str());
+        return 1;
+    }
+    return 0;
+}
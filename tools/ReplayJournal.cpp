@@ -0,0 +1,126 @@
+/****************************************************************************
+ Copyright (c) 2015 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+// Replays a run journal headless, as fast as possible.
+//
+//   replay_journal last_run.journal [--pack maps.pkm] [--repeat N]
+//
+// Games write last_run.journal to their writable path at game over.
+// The journal has the world config of the device, which is used for the
+// replay. --pack must be the map pack the game used (it uses one when
+// Resources/maps/maps.pkm is shipped): the journal records its hash and
+// the replay refuses other maps. --repeat replays it N times, useful to
+// profile a run that was slow on a device.
+// Exits with 1 if the maps differ or the replay doesn't end as the
+// recorded run.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+
+#include "InputJournal.h"
+#include "MapPack.h"
+#include "World.h"
+
+static std::string describeMaps(uint64_t packHash)
+{
+    if (!packHash)
+        return "the built-in maps";
+    char buffer[40];
+    snprintf(buffer, sizeof(buffer), "map pack %016llx", (unsigned long long)packHash);
+    return buffer;
+}
+
+int main(int argc, char** argv)
+{
+    std::string journalPath;
+    std::string packPath;
+    int repeat = 1;
+
+    for (int i=1; i<argc; i++)
+    {
+        if (strcmp(argv[i], "--pack") == 0 && i+1 < argc)
+            packPath = argv[++i];
+        else if (strcmp(argv[i], "--repeat") == 0 && i+1 < argc)
+            repeat = atoi(argv[++i]);
+        else
+            journalPath = argv[i];
+    }
+
+    if (journalPath.empty() || repeat < 1)
+    {
+        fprintf(stderr, "usage: replay_journal run.journal [--pack maps.pkm] [--repeat N]\n");
+        return 1;
+    }
+
+    InputJournal journal;
+    if (!journal.load(journalPath))
+    {
+        fprintf(stderr, "replay_journal: %s is not a valid journal\n", journalPath.c_str());
+        return 1;
+    }
+
+    MapPack pack;
+    if (!packPath.empty() && !pack.initWithFile(packPath))
+    {
+        fprintf(stderr, "replay_journal: %s is not a valid map pack\n", packPath.c_str());
+        return 1;
+    }
+
+    World world;
+    if (!packPath.empty())
+        world.setMapPack(&pack);
+    if (!journal.hasSameMaps(world))
+    {
+        fprintf(stderr, "replay_journal: the run was recorded with %s, replaying with %s. Pass the same maps with --pack\n",
+                describeMaps(journal.getPackHash()).c_str(), describeMaps(pack.getHash()).c_str());
+        return 1;
+    }
+
+    bool same = true;
+    long long steps = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i=0; i<repeat; i++)
+    {
+        same = journal.replay(world) && same;
+        steps += world.getStepCount();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    printf("seed %u, %d inputs\n", (unsigned int)journal.getSeed(), (int)journal.getEntries().size());
+    if (journal.isFinished())
+        printf("recorded: %d steps, score %d\n", journal.getSteps(), journal.getScore());
+    printf("replayed: %d steps, score %d%s\n", world.getStepCount(), world.getScore(),
+           world.getActorMode() == World::GAMEOVER ? ", game over" : "");
+    printf("%.0f steps/s (%.1fx real time)\n", steps / elapsed.count(), steps * World::FIXED_DT / elapsed.count());
+
+    if (!same)
+    {
+        fprintf(stderr, "replay_journal: the replay doesn't match the recorded run\n");
+        return 1;
+    }
+    return 0;
+}